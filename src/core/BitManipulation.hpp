@@ -6,6 +6,10 @@
 #include <limits>
 #include <type_traits>
 
+#if defined( __BMI2__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    #include <immintrin.h>
+#endif
+
 
 [[nodiscard]] inline bool
 isLittleEndian()
@@ -100,6 +104,31 @@ static constexpr std::array<T, 256U> N_LOWEST_BITS_SET_LUT =
     }();
 
 
+/**
+ * Returns the lowest @p nBitsToKeep bits of @p value with all higher bits cleared.
+ * This is the hot mask-and-extract operation applied to every decoded symbol. With BMI2, BZHI does it
+ * in a single instruction, including the @p nBitsToKeep >= width edge case, which returns the value
+ * unchanged just like the mask lookup table does. Without BMI2, the lookup table avoids the
+ * shift/subtract sequence and its undefined behavior for a full-width shift.
+ */
+template<typename T>
+[[nodiscard]] inline T
+keepLowestBits( const T       value,
+                const uint8_t nBitsToKeep )
+{
+    static_assert( std::is_unsigned_v<T>, "Type must be unsigned!" );
+#if defined( __BMI2__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    if constexpr ( sizeof( T ) == sizeof( uint64_t ) ) {
+        return static_cast<T>( _bzhi_u64( value, nBitsToKeep ) );
+    } else {
+        return static_cast<T>( _bzhi_u32( static_cast<uint32_t>( value ), nBitsToKeep ) );
+    }
+#else
+    return value & N_LOWEST_BITS_SET_LUT<T>[nBitsToKeep];
+#endif
+}
+
+
 template<typename T>
 [[nodiscard]] constexpr T
 nHighestBitsSet( uint8_t nBitsSet )
@@ -20,6 +20,7 @@
 
 #include <BitManipulation.hpp>
 #include <common.hpp>
+#include <FasterVector.hpp>
 #include <filereader/FileReader.hpp>
 #include <filereader/Shared.hpp>
 
@@ -130,6 +131,21 @@ public:
         seek( other.tell() );
     }
 
+    /**
+     * Rebinds the bit reader to another file and clears all buffered state. In contrast to constructing
+     * a new BitReader, the input buffer keeps its allocation, which avoids heap churn when one reader
+     * is reused for many small inputs.
+     */
+    void
+    reset( UniqueFileReader fileReader )
+    {
+        m_file = ensureSharedFileReader( std::move( fileReader ) );
+        m_inputBuffer.clear();
+        m_inputBufferPosition = 0;
+        clearBitBuffer();
+        m_statistics = Statistics{};
+    }
+
     /* File Reader Interface Implementation */
 
     [[nodiscard]] UniqueFileReader
@@ -186,7 +202,7 @@ public:
      * Note that splitting part of this method off into readSafe made the compiler actually
      * inline this now small function and thereby sped up runtimes significantly!
      */
-    forceinline BitBuffer
+    hotfunction forceinline BitBuffer
     read( bit_count_t bitsWanted )
     {
         /* Handling bitsWanted == 0 here would incure a 75% slowdown for the benchmark reading single bits!
@@ -217,12 +233,12 @@ private:
          * This is copy-pasted from @ref peekUnsafe because for MSB, we don't have to do the expensive
          * bitBufferSize() == 0 branching! */
         if constexpr ( MOST_SIGNIFICANT_BITS_FIRST ) {
-            bits = m_bitBuffer & N_LOWEST_BITS_SET_LUT<BitBuffer>[bitBufferSize()];
+            bits = keepLowestBits( m_bitBuffer, static_cast<uint8_t>( bitBufferSize() ) );
         } else {
             bits = bitBufferSize() == 0
                    ? BitBuffer( 0 )
-                   : ( m_bitBuffer >> m_bitBufferFree )
-                     & N_LOWEST_BITS_SET_LUT<BitBuffer>[bitBufferSize()];
+                   : keepLowestBits( static_cast<BitBuffer>( m_bitBuffer >> m_bitBufferFree ),
+                                     static_cast<uint8_t>( bitBufferSize() ) );
         }
 
         /* If the system endianness matches the BitReader endianness and the byte buffer contains enough bytes
@@ -239,6 +255,7 @@ private:
                 m_bitBuffer = loadUnaligned<BitBuffer>( &m_inputBuffer[m_inputBufferPosition] );
 
                 m_inputBufferPosition += BYTES_WANTED;
+                prefetchUpcomingInputBytes();
 
                 bits |= peekUnsafe( bitsNeeded ) << bitsInResult;
                 seekAfterPeek( bitsNeeded );
@@ -248,6 +265,32 @@ private:
             }
         }
 
+        /* Same bulk refill for the MSB (bzip2) bit order. Byte-swapping the unaligned load moves the first
+         * stream byte into the most significant byte, which is exactly the left-to-right reading order of
+         * the MSB bit buffer. This replaces the byte-wise loop with its bounds check per appended byte by
+         * a single load whose address is known before the previous symbol has been decoded.
+         * With the swap paid once per refill, extraction in peekUnsafe is a shift of the unread-bit count
+         * plus a (BZHI) mask, i.e., the same instruction count as the LSB path. */
+        if constexpr ( MOST_SIGNIFICANT_BITS_FIRST && ( ENDIAN == Endian::LITTLE ) && ( sizeof( BitBuffer ) > 1 ) ) {
+            constexpr bit_count_t BYTES_WANTED = sizeof( BitBuffer );
+            constexpr bit_count_t BITS_WANTED = sizeof( BitBuffer ) * CHAR_BIT;
+
+            if ( LIKELY( m_inputBufferPosition + BYTES_WANTED < m_inputBuffer.size() ) ) [[likely]] {
+                m_originalBitBufferSize = BITS_WANTED;
+                m_bitBufferFree = MAX_BIT_BUFFER_SIZE - BITS_WANTED;
+                m_bitBuffer = byteSwap( loadUnaligned<BitBuffer>( &m_inputBuffer[m_inputBufferPosition] ) );
+
+                m_inputBufferPosition += BYTES_WANTED;
+                prefetchUpcomingInputBytes();
+
+                bits = ( bits << bitsNeeded ) | peekUnsafe( bitsNeeded );
+                seekAfterPeek( bitsNeeded );
+
+                m_statistics.bitBufferRefillCount++;
+                return bits;
+            }
+        }
+
         clearBitBuffer();
         try {
             fillBitBuffer();
@@ -292,15 +335,25 @@ public:
      * Forcing to inline this function is superimportant because it depends even between gcc versions,
      * whether it is actually inlined or not but inlining can save 30%!
      */
+    /**
+     * With the bit count being a template argument, the mask and shift amounts are compile-time constants,
+     * so the frequent-path extraction folds into a load-free shift-and-and sequence no matter whether the
+     * runtime path would use the mask lookup table or BZHI. Only the infrequent refill stays a runtime call.
+     */
     template<uint8_t bitsWanted>
-    forceinline BitBuffer
+    hotfunction forceinline BitBuffer
     read()
     {
         if constexpr ( bitsWanted == 0 ) {
             return 0;
         } else {
             static_assert( bitsWanted <= MAX_BIT_BUFFER_SIZE, "Requested bits must fit in buffer!" );
-            return read( bitsWanted );
+            if ( LIKELY( bitsWanted <= bitBufferSize() ) ) [[likely]] {
+                const auto result = peekUnsafe<bitsWanted>();
+                seekAfterPeek( bitsWanted );
+                return result;
+            }
+            return read2( bitsWanted );
         }
     }
 
@@ -375,14 +428,17 @@ public:
     }
 
     template<uint8_t bitsWanted>
-    forceinline BitBuffer
+    hotfunction forceinline BitBuffer
     peek()
     {
         if constexpr ( bitsWanted == 0 ) {
             return 0;
         } else {
             static_assert( bitsWanted <= MAX_BIT_BUFFER_SIZE, "Requested bits must fit in buffer!" );
-            return peek( bitsWanted );
+            if ( LIKELY( bitsWanted <= bitBufferSize() ) ) [[likely]] {
+                return peekUnsafe<bitsWanted>();
+            }
+            return peek2( bitsWanted );
         }
     }
 
@@ -404,6 +460,7 @@ private:
                         m_bitBuffer = loadUnaligned<BitBuffer>( &m_inputBuffer[m_inputBufferPosition] );
 
                         m_inputBufferPosition += sizeof( BitBuffer );
+                        prefetchUpcomingInputBytes();
                         return peekUnsafe( bitsWanted );
                     }
 
@@ -421,6 +478,42 @@ private:
                     m_originalBitBufferSize = MAX_BIT_BUFFER_SIZE;
                     m_bitBufferFree -= bitsToLoad;
                     m_inputBufferPosition += bytesToLoad;
+                    prefetchUpcomingInputBytes();
+
+                    return peekUnsafe( bitsWanted );
+                }
+            }
+
+            if constexpr ( MOST_SIGNIFICANT_BITS_FIRST && ( ENDIAN == Endian::LITTLE )
+                           && ( sizeof( BitBuffer ) > 1 ) ) {
+                if ( LIKELY( m_inputBufferPosition + sizeof( BitBuffer ) < m_inputBuffer.size() ) ) [[likely]] {
+                    if ( bitBufferSize() == 0 ) {
+                        m_originalBitBufferSize = sizeof( BitBuffer ) * CHAR_BIT;
+                        m_bitBufferFree = MAX_BIT_BUFFER_SIZE - sizeof( BitBuffer ) * CHAR_BIT;
+                        m_bitBuffer = byteSwap( loadUnaligned<BitBuffer>( &m_inputBuffer[m_inputBufferPosition] ) );
+
+                        m_inputBufferPosition += sizeof( BitBuffer );
+                        prefetchUpcomingInputBytes();
+                        return peekUnsafe( bitsWanted );
+                    }
+
+                    const auto shrinkedBitBufferSize = ceilDiv( bitBufferSize(), CHAR_BIT ) * CHAR_BIT;
+                    const auto bitsToLoad  = MAX_BIT_BUFFER_SIZE - shrinkedBitBufferSize;
+                    const auto bytesToLoad = bitsToLoad / CHAR_BIT;
+
+                    /* Shift the (virtually) shrinked bit buffer to the left and append the topmost bits of the
+                     * byte-swapped load below it. The already read bits inside the shrinked byte stay above the
+                     * unread ones so that m_originalBitBufferSize remains byte-aligned for seeking back. */
+                    const auto bytesToAppend =
+                        byteSwap( loadUnaligned<BitBuffer>( &m_inputBuffer[m_inputBufferPosition] ) );
+                    m_bitBuffer = ( keepLowestBits( m_bitBuffer, static_cast<uint8_t>( shrinkedBitBufferSize ) )
+                                    << bitsToLoad )
+                                  | ( bytesToAppend >> shrinkedBitBufferSize );
+
+                    m_originalBitBufferSize = MAX_BIT_BUFFER_SIZE;
+                    m_bitBufferFree -= bitsToLoad;
+                    m_inputBufferPosition += bytesToLoad;
+                    prefetchUpcomingInputBytes();
 
                     return peekUnsafe( bitsWanted );
                 }
@@ -465,7 +558,7 @@ private:
     }
 
 public:
-    forceinline BitBuffer
+    hotfunction forceinline BitBuffer
     peek( bit_count_t bitsWanted )
     {
         if ( UNLIKELY( bitsWanted > bitBufferSize() ) ) [[unlikely]] {
@@ -542,7 +635,7 @@ public:
         return sizeInBytes * CHAR_BIT;
     }
 
-    [[nodiscard]] const std::vector<std::uint8_t>&
+    [[nodiscard]] const FasterVector<std::uint8_t>&
     buffer() const
     {
         return m_inputBuffer;
@@ -561,10 +654,10 @@ public:
     }
 
 private:
-    size_t
+    coldfunction size_t
     fullSeek( size_t offsetBits );
 
-    void
+    coldfunction void
     refillBuffer()
     {
         if ( UNLIKELY( !m_file ) ) [[unlikely]] {
@@ -585,6 +678,21 @@ private:
         m_statistics.byteBufferRefillCount++;
     }
 
+    /**
+     * Requests the cache line after the current read position so that it is already in flight when the
+     * next bit buffer refill loads from it. Issued on every bulk refill because by then the previous
+     * line has mostly been consumed. The address does not need to be checked against the buffer end,
+     * prefetches are only hints and never fault.
+     */
+    forceinline void
+    prefetchUpcomingInputBytes() const
+    {
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        __builtin_prefetch( m_inputBuffer.data() + m_inputBufferPosition + 64,
+                            /* read */ 0, /* no temporal locality */ 0 );
+    #endif
+    }
+
     /**
      * Decreases m_originalBitBufferSize by CHAR_BIT until it is as close to bitBufferSize() as possible
      * and clears all bits outside of m_originalBitBufferSize.
@@ -709,15 +817,15 @@ private:
         m_statistics.bitBufferRefillCount++;
     }
 
-    [[nodiscard]] forceinline BitBuffer
+    [[nodiscard]] hotfunction forceinline BitBuffer
     peekUnsafe( bit_count_t bitsWanted ) const
     {
         assert( bitsWanted <= bitBufferSize() );
         assert( bitsWanted > 0 );
 
         if constexpr ( MOST_SIGNIFICANT_BITS_FIRST ) {
-            return ( m_bitBuffer >> ( bitBufferSize() - bitsWanted ) )
-                   & N_LOWEST_BITS_SET_LUT<BitBuffer>[bitsWanted];
+            return keepLowestBits( static_cast<BitBuffer>( m_bitBuffer >> ( bitBufferSize() - bitsWanted ) ),
+                                   static_cast<uint8_t>( bitsWanted ) );
         } else {
             assert( bitBufferSize() > 0 );
             /* Always checking for bitBufferSize() for this damn bit shift would be too cost-prohibitive.
@@ -725,8 +833,27 @@ private:
              * for the shift result value does not matter. Run unit tests in debug mode to ensure that the assert
              * won't be triggered. */
             // NOLINTNEXTLINE(clang-analyzer-core.UndefinedBinaryOperatorResult)
-            return ( m_bitBuffer >> m_bitBufferFree )
-                   & N_LOWEST_BITS_SET_LUT<BitBuffer>[bitsWanted];
+            return keepLowestBits( static_cast<BitBuffer>( m_bitBuffer >> m_bitBufferFree ),
+                                   static_cast<uint8_t>( bitsWanted ) );
+        }
+    }
+
+    /** Compile-time bit count variant of @ref peekUnsafe with the mask folded into an immediate. */
+    template<uint8_t bitsWanted>
+    [[nodiscard]] hotfunction forceinline BitBuffer
+    peekUnsafe() const
+    {
+        static_assert( bitsWanted > 0, "Must request at least one bit!" );
+        assert( bitsWanted <= bitBufferSize() );
+
+        constexpr auto MASK = nLowestBitsSet<BitBuffer, bitsWanted>();
+        if constexpr ( MOST_SIGNIFICANT_BITS_FIRST ) {
+            return ( m_bitBuffer >> ( bitBufferSize() - bitsWanted ) ) & MASK;
+        } else {
+            assert( bitBufferSize() > 0 );
+            /* See the non-templated peekUnsafe for why the possible undefined shift cannot trigger here. */
+            // NOLINTNEXTLINE(clang-analyzer-core.UndefinedBinaryOperatorResult)
+            return ( m_bitBuffer >> m_bitBufferFree ) & MASK;
         }
     }
 
@@ -749,7 +876,10 @@ private:
     UniqueFileReader m_file;
 
     size_t m_bufferRefillSize{ DEFAULT_BUFFER_REFILL_SIZE };
-    std::vector<uint8_t> m_inputBuffer;
+    /* FasterVector allocates through rpmalloc's per-thread caches when available, so the frequent
+     * construction of one BitReader per decoded chunk effectively reuses the same buffer memory
+     * instead of contending on the global allocator. */
+    FasterVector<uint8_t> m_inputBuffer;
     size_t m_inputBufferPosition = 0;  /** stores current position of first valid byte in buffer */
 
     /* Performance profiling metrics. */
@@ -876,14 +1006,18 @@ BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>::seek(
 
     const auto positiveOffsetBits = effectiveOffset( offsetBits, origin );
 
-    if ( positiveOffsetBits == tell() ) {
+    /* Cache the current position. Each tell() call queries the underlying SharedFileReader under its mutex,
+     * which adds up for the frequent small seeks preceding reads. */
+    const auto currentPosition = tell();
+
+    if ( positiveOffsetBits == currentPosition ) {
         return positiveOffsetBits;
     }
 
-    if ( !seekable() && ( positiveOffsetBits < tell() ) ) {
+    if ( !seekable() && ( positiveOffsetBits < currentPosition ) ) {
         std::stringstream message;
         message << "File is not seekable! Requested to seek to " << formatBits( positiveOffsetBits )
-                << ". Currently at: " << formatBits( tell() );
+                << ". Currently at: " << formatBits( currentPosition );
         throw std::invalid_argument( std::move( message ).str() );
     }
 
@@ -893,8 +1027,8 @@ BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>::seek(
     }
 
     /* Performance optimizations for faster seeking inside the buffer to avoid expensive refillBuffer calls. */
-    if ( positiveOffsetBits >= tell() ) {
-        const auto relativeOffsets = positiveOffsetBits - tell();
+    if ( positiveOffsetBits >= currentPosition ) {
+        const auto relativeOffsets = positiveOffsetBits - currentPosition;
         /* Seek forward inside bit buffer. */
         if ( static_cast<size_t>( relativeOffsets ) <= bitBufferSize() ) {
             seekAfterPeek( static_cast<decltype( bitBufferSize() )>( relativeOffsets ) );
@@ -915,7 +1049,7 @@ BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>::seek(
             return positiveOffsetBits;
         }
     } else {  /* Seek back. */
-        const auto relativeOffsets = tell() - positiveOffsetBits;
+        const auto relativeOffsets = currentPosition - positiveOffsetBits;
         /* Seek back inside bit buffer. */
         if ( relativeOffsets + bitBufferSize() <= m_originalBitBufferSize ) {
             m_bitBufferFree -= static_cast<decltype( bitBufferSize() )>( relativeOffsets );
@@ -943,7 +1077,7 @@ BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>::seek(
 
 
 template<bool MOST_SIGNIFICANT_BITS_FIRST, typename BitBuffer>
-inline size_t
+size_t
 BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>::fullSeek( size_t offsetBits )
 {
     if ( !m_file ) {
@@ -20,8 +20,64 @@
 #include <common.hpp>
 #include <BitManipulation.hpp>
 #include <filereader/FileReader.hpp>
+#include <filereader/Shared.hpp>
 #include <filereader/Standard.hpp>
 
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+    #define BIT_STRING_FINDER_WITH_AVX2
+    #include <immintrin.h>
+#endif
+
+
+#ifdef BIT_STRING_FINDER_WITH_AVX2
+/**
+ * Sliding two-byte anchor compare over 32-byte blocks. Testing the first two pattern bytes at
+ * once thins out candidates to ~1/65536 per position on random data, so the full comparison
+ * is almost never executed. This beats the byte-wise std::string_view::find, which only skips
+ * with memchr on the first byte.
+ *
+ * Compiled unconditionally with the AVX2 target attribute and selected at runtime via
+ * __builtin_cpu_supports so that baseline builds, e.g., manylinux wheels, also benefit.
+ *
+ * @return the number of leading bytes that have been scanned. The caller must continue the search from there.
+ */
+__attribute__(( target( "avx2" ) )) [[nodiscard]] inline size_t
+findTwoByteAnchoredStringsAVX2( std::string_view const& data,
+                                std::string_view const& stringToFind,
+                                std::vector<size_t>&    blockOffsets )
+{
+    constexpr size_t BLOCK_SIZE = sizeof( __m256i );
+    const auto first  = _mm256_set1_epi8( stringToFind[0] );
+    const auto second = _mm256_set1_epi8( stringToFind[1] );
+    const auto nCandidates = data.size() >= stringToFind.size()
+                             ? data.size() - stringToFind.size() + 1U
+                             : size_t( 0 );
+
+    size_t searchStart{ 0 };
+    for ( ; searchStart + BLOCK_SIZE + 1U <= data.size(); searchStart += BLOCK_SIZE ) {
+        const auto block0 =
+            _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data.data() + searchStart ) );
+        const auto block1 =
+            _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data.data() + searchStart + 1U ) );
+        auto hits = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( block0, first ) ) )
+                    & static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( block1, second ) ) );
+
+        while ( hits != 0 ) {
+            const auto position = searchStart + static_cast<size_t>( __builtin_ctz( hits ) );
+            hits &= hits - 1U;
+
+            if ( ( position < nCandidates )
+                 && ( std::memcmp( data.data() + position + 2U, stringToFind.data() + 2U,
+                                   stringToFind.size() - 2U ) == 0 ) )
+            {
+                blockOffsets.push_back( position );
+            }
+        }
+    }
+    return searchStart;
+}
+#endif  // BIT_STRING_FINDER_WITH_AVX2
+
 
 /**
  * No matter the input, the data is read from an input buffer.
@@ -49,10 +105,24 @@ public:
     BitStringFinder( UniqueFileReader fileReader,
                      uint64_t         bitStringToFind,
                      size_t           fileBufferSizeBytes = 1_Mi ) :
-        m_bitStringToFind( bitStringToFind & nLowestBitsSet<uint64_t>( bitStringSize ) ),
+        BitStringFinder( std::move( fileReader ), std::vector<uint64_t>{ bitStringToFind }, fileBufferSizeBytes )
+    {}
+
+    /**
+     * Looks for all given bit strings in a single pass over the input. The scan cost grows with the
+     * number of bit strings while the I/O cost stays constant, so searching for the bzip2 block and
+     * end-of-stream magics together halves the read volume compared to two separate passes.
+     */
+    BitStringFinder( UniqueFileReader      fileReader,
+                     std::vector<uint64_t> bitStringsToFind,
+                     size_t                fileBufferSizeBytes = 1_Mi ) :
+        m_bitStringsToFind( maskToLength( std::move( bitStringsToFind ) ) ),
         m_movingBitsToKeep( bitStringSize > 0 ? bitStringSize - 1U : 0U ),
         m_movingBytesToKeep( ceilDiv( m_movingBitsToKeep, CHAR_BIT ) ),
-        m_fileReader( std::move( fileReader ) ),
+        /* Wrapping in a SharedFileReader makes buffer refills go through pread on the tracked position,
+         * so several finders, e.g., one per prefetcher thread, can share one file descriptor without
+         * serializing on seek+read pairs. */
+        m_fileReader( fileReader ? ensureSharedFileReader( std::move( fileReader ) ) : UniqueFileReader() ),
         m_fileChunksInBytes( std::max( fileBufferSizeBytes,
                                        static_cast<size_t>( ceilDiv( bitStringSize, CHAR_BIT ) ) ) )
     {
@@ -100,7 +170,45 @@ public:
     [[nodiscard]] virtual size_t
     find();
 
+    /**
+     * Retrieves up to @p maxMatches matches with a single call and returns the number of matches written
+     * to @p output. Matches already gathered by the last buffer scan are drained in one tight loop, so the
+     * caller pays one call boundary per buffer window instead of one state machine re-entry per match.
+     */
+    [[nodiscard]] size_t
+    findBatch( size_t* const output,
+               size_t  const maxMatches )
+    {
+        size_t nMatches = 0;
+
+        /* Drain offsets found by the previous scan without re-entering the full search state machine.
+         * This loop is a no-op for derived classes that do not use m_offsetsInBuffer. */
+        while ( ( nMatches < maxMatches ) && !m_offsetsInBuffer.empty() ) {
+            output[nMatches++] = m_nTotalBytesRead * CHAR_BIT + m_offsetsInBuffer.back();
+            m_offsetsInBuffer.pop_back();
+        }
+
+        for ( ; nMatches < maxMatches; ++nMatches ) {
+            const auto match = find();
+            if ( match == std::numeric_limits<size_t>::max() ) {
+                break;
+            }
+            output[nMatches] = match;
+        }
+
+        return nMatches;
+    }
+
 protected:
+    [[nodiscard]] static std::vector<uint64_t>
+    maskToLength( std::vector<uint64_t> bitStrings )
+    {
+        for ( auto& bitString : bitStrings ) {
+            bitString &= nLowestBitsSet<uint64_t>( bitStringSize );
+        }
+        return bitStrings;
+    }
+
     [[nodiscard]] bool
     bufferEof() const
     {
@@ -119,7 +227,7 @@ public:
                     uint64_t                bitString );
 
 protected:
-    const uint64_t m_bitStringToFind;
+    const std::vector<uint64_t> m_bitStringsToFind;
 
     /**
      * If the bit string is only one bit long, then we don't need to keep bits from the current buffer.
@@ -167,7 +275,18 @@ BitStringFinder<bitStringSize>::findBitStrings( std::string_view const& buffer,
              std::string_view const& stringToFind )
         {
             std::vector<size_t> blockOffsets;
-            for ( auto position = data.find( stringToFind, 0 );
+            size_t searchStart{ 0 };
+
+        #ifdef BIT_STRING_FINDER_WITH_AVX2
+            if ( stringToFind.size() >= 2 ) {
+                static const bool avx2Supported = __builtin_cpu_supports( "avx2" ) != 0;
+                if ( avx2Supported ) {
+                    searchStart = findTwoByteAnchoredStringsAVX2( data, stringToFind, blockOffsets );
+                }
+            }
+        #endif  // BIT_STRING_FINDER_WITH_AVX2
+
+            for ( auto position = data.find( stringToFind, searchStart );
                   position != std::string_view::npos;
                   position = data.find( stringToFind, position + 1U ) )
             {
@@ -199,8 +318,10 @@ BitStringFinder<bitStringSize>::findBitStrings( std::string_view const& buffer,
             if ( ( offset == 0 ) || ( ( offset - 1 ) >= buffer.size() ) ) {
                 return false;
             }
-            return ( static_cast<uint8_t>( buffer[offset - 1] ) & nLowestBitsSet<uint64_t>( nBitsBefore ) )
-                   == ( ( bitString >> ( bitStringSize - nBitsBefore ) ) & nLowestBitsSet<uint64_t>( nBitsBefore ) );
+            return keepLowestBits( static_cast<uint64_t>( static_cast<uint8_t>( buffer[offset - 1] ) ),
+                                   static_cast<uint8_t>( nBitsBefore ) )
+                   == keepLowestBits( bitString >> ( bitStringSize - nBitsBefore ),
+                                      static_cast<uint8_t>( nBitsBefore ) );
         };
 
     const auto tailMatches =
@@ -214,7 +335,7 @@ BitStringFinder<bitStringSize>::findBitStrings( std::string_view const& buffer,
                 return false;
             }
             return ( static_cast<uint64_t>( static_cast<uint8_t>( buffer[offset] ) ) >> ( CHAR_BIT - nBitsAfter ) )
-                   == ( bitString & nLowestBitsSet<uint64_t>( nBitsAfter ) );
+                   == keepLowestBits( bitString, static_cast<uint8_t>( nBitsAfter ) );
         };
 
     std::vector<size_t> blockOffsets;
@@ -260,7 +381,13 @@ BitStringFinder<bitStringSize>::find()
             }
         }
 
-        m_offsetsInBuffer = findBitStrings( { m_buffer.data(), m_buffer.size() }, m_bitStringToFind );
+        /* The buffer is scanned once per bit string, so the file is still only read once.
+         * The merged results get ordered by the sort below anyway. */
+        m_offsetsInBuffer.clear();
+        for ( const auto bitStringToFind : m_bitStringsToFind ) {
+            auto newOffsets = findBitStrings( { m_buffer.data(), m_buffer.size() }, bitStringToFind );
+            m_offsetsInBuffer.insert( m_offsetsInBuffer.end(), newOffsets.begin(), newOffsets.end() );
+        }
 
         const auto firstBitsToIgnore = static_cast<uint8_t>( m_bufferBitsRead % CHAR_BIT );
         m_offsetsInBuffer.erase(
@@ -236,6 +236,19 @@ public:
         return { m_blockToDataOffsets.begin(), m_blockToDataOffsets.end() };
     }
 
+    /**
+     * Same data as @ref blockOffsets but returned as the internally stored contiguous vector so that
+     * analysis loops over possibly hundreds of thousands of seek points do not have to pay for building
+     * and then pointer-chasing a tree-based map.
+     */
+    [[nodiscard]] BlockOffsets
+    blockOffsetsVector() const
+    {
+        std::scoped_lock lock( m_mutex );
+
+        return m_blockToDataOffsets;
+    }
+
     [[nodiscard]] std::pair<size_t, size_t>
     back() const
     {
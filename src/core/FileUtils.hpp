@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -13,6 +14,9 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
+
+#include <AlignedAllocator.hpp>
 
 #ifdef __APPLE_CC__
     #include <AvailabilityMacros.h>
@@ -34,14 +38,18 @@
     #include <fcntl.h>
     #include <limits.h>         // IOV_MAX
     #include <sys/stat.h>
+    #ifdef __linux__
+        #include <sys/sysmacros.h>  // major, minor
+    #endif
     #if defined(__linux__) || defined(__APPLE__)
         #include <sys/uio.h>
     #endif
     #include <unistd.h>
 
-    //#if not defined( HAVE_VMSPLICE ) and defined( __linux__ ) and defined( F_GETPIPE_SZ )
-    //    #define HAVE_VMSPLICE
-    //#endif
+    #if defined( RAPIDGZIP_ENABLE_VMSPLICE ) and not defined( HAVE_VMSPLICE ) \
+        and defined( __linux__ ) and defined( F_GETPIPE_SZ )
+        #define HAVE_VMSPLICE
+    #endif
 
     #if not defined( HAVE_IOVEC ) and defined( __linux__ )
         #define HAVE_IOVEC
@@ -55,8 +63,12 @@
  * is as stated below with a custom mmap allocator + vmsplice gift.
  * Too bad, because it gave quite some performance, but it's no use when the results are wrong.
  * https://github.com/mxmlnkn/rapidgzip/issues/39
+ * The zero-copy pipe output saves one memcpy per decompressed byte, so keep it available as an explicit
+ * opt-in via -DRAPIDGZIP_ENABLE_VMSPLICE for benchmarking and for callers that are sure to drain the pipe.
  */
-#undef HAVE_VMSPLICE
+#ifndef RAPIDGZIP_ENABLE_VMSPLICE
+    #undef HAVE_VMSPLICE
+#endif
 
 
 #if defined( HAVE_VMSPLICE )
@@ -71,7 +83,9 @@
 [[nodiscard]] inline bool
 stdinHasInput()
 {
-    return _isatty( _fileno( stdin ) ) == 0;
+    /* A pure function of process state, so query it only once even when called multiple times. */
+    static const bool result = _isatty( _fileno( stdin ) ) == 0;
+    return result;
 }
 
 
@@ -90,20 +104,36 @@ stdoutIsDevNull()
 [[nodiscard]] inline bool
 stdinHasInput()
 {
-    return isatty( STDIN_FILENO ) == 0;
+    /* A pure function of process state, so query it only once even when called multiple times. */
+    static const bool result = isatty( STDIN_FILENO ) == 0;
+    return result;
 }
 
 
 [[nodiscard]] inline bool
 stdoutIsDevNull()
 {
-    struct stat devNull{};
-    struct stat stdOut{};
-    return ( fstat( STDOUT_FILENO, &stdOut ) == 0 ) &&
-           ( stat( "/dev/null", &devNull ) == 0 ) &&
-           S_ISCHR( stdOut.st_mode ) &&  // NOLINT
-           ( devNull.st_dev == stdOut.st_dev ) &&
-           ( devNull.st_ino == stdOut.st_ino );
+    /* Cached because neither the standard output descriptor nor /dev/null change identity
+     * during the process lifetime. */
+    static const bool result =
+        [] ()
+        {
+            struct stat stdOut{};
+            if ( ( fstat( STDOUT_FILENO, &stdOut ) != 0 ) || !S_ISCHR( stdOut.st_mode ) ) {  // NOLINT
+                return false;
+            }
+        #ifdef __linux__
+            /* The null device always has the fixed device number major 1, minor 3 on Linux,
+             * which saves the path lookup and stat of /dev/null. */
+            return ( major( stdOut.st_rdev ) == 1U ) && ( minor( stdOut.st_rdev ) == 3U );
+        #else
+            struct stat devNull{};
+            return ( stat( "/dev/null", &devNull ) == 0 ) &&
+                   ( devNull.st_dev == stdOut.st_dev ) &&
+                   ( devNull.st_ino == stdOut.st_ino );
+        #endif
+        }();
+    return result;
 }
 #endif
 
@@ -819,6 +849,128 @@ private:
 };
 
 
+#if defined( __linux__ ) && defined( O_DIRECT )
+    #define HAVE_O_DIRECT
+/**
+ * Write buffer for write-once-and-close flows such as exporting an index. Data is gathered into a
+ * page-aligned 1 MiB buffer and flushed with O_DIRECT writes so that writing out a possibly GiB-sized
+ * file does not evict pages that concurrent readers, e.g., the decoder threads, still profit from.
+ * Direct I/O requires block-aligned write sizes, so the trailing partial block is written only on
+ * @ref close after clearing the O_DIRECT flag again.
+ */
+class DirectWriteFileBuffer
+{
+public:
+    explicit
+    DirectWriteFileBuffer( const std::string& filePath ) :
+        m_fileDescriptor( ::open( filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0666 ) ),
+        m_ownedFd( m_fileDescriptor )
+    {
+        if ( m_fileDescriptor == -1 ) {
+            std::stringstream message;
+            message << "Could not open output file: " << filePath << " with direct I/O because of: "
+                    << strerror( errno ) << " (" << errno << ")";
+            throw std::runtime_error( std::move( message ).str() );
+        }
+        m_buffer.resize( BUFFER_SIZE );
+    }
+
+    ~DirectWriteFileBuffer()
+    {
+        try {
+            close();
+        } catch ( const std::exception& exception ) {
+            std::cerr << "[Warning] Failed to flush direct I/O write buffer because of: " << exception.what() << "\n";
+        }
+    }
+
+    DirectWriteFileBuffer( const DirectWriteFileBuffer& ) = delete;
+    DirectWriteFileBuffer( DirectWriteFileBuffer&& ) = delete;
+    DirectWriteFileBuffer& operator=( const DirectWriteFileBuffer& ) = delete;
+    DirectWriteFileBuffer& operator=( DirectWriteFileBuffer&& ) = delete;
+
+    void
+    write( const void* const dataToWrite,
+           const size_t      dataToWriteSize )
+    {
+        const auto* data = reinterpret_cast<const char*>( dataToWrite );
+        for ( size_t nBytesCopied = 0; nBytesCopied < dataToWriteSize; ) {
+            const auto chunkSize = std::min( dataToWriteSize - nBytesCopied, BUFFER_SIZE - m_bufferFillLevel );
+            std::memcpy( m_buffer.data() + m_bufferFillLevel, data + nBytesCopied, chunkSize );
+            m_bufferFillLevel += chunkSize;
+            nBytesCopied += chunkSize;
+
+            if ( m_bufferFillLevel == BUFFER_SIZE ) {
+                flushAlignedBlocks();
+            }
+        }
+    }
+
+    /**
+     * Flushes the trailing partial block without direct I/O and closes the file. Throws on write errors.
+     */
+    void
+    close()
+    {
+        if ( m_fileDescriptor == -1 ) {
+            return;
+        }
+
+        flushAlignedBlocks();
+
+        if ( m_bufferFillLevel > 0 ) {
+            /* The tail is smaller than the direct I/O block size, so write it through the page cache. */
+            const auto flags = ::fcntl( m_fileDescriptor, F_GETFL );
+            if ( ( flags == -1 ) || ( ::fcntl( m_fileDescriptor, F_SETFL, flags & ~O_DIRECT ) == -1 ) ) {
+                throw std::runtime_error( "Failed to disable direct I/O for the trailing partial block!" );
+            }
+            checkedWrite( m_buffer.data(), m_bufferFillLevel );
+            m_bufferFillLevel = 0;
+        }
+
+        m_ownedFd.close();
+        m_fileDescriptor = -1;
+    }
+
+private:
+    void
+    flushAlignedBlocks()
+    {
+        const auto alignedSize = m_bufferFillLevel - ( m_bufferFillLevel % BLOCK_SIZE );
+        if ( alignedSize == 0 ) {
+            return;
+        }
+
+        checkedWrite( m_buffer.data(), alignedSize );
+        std::memmove( m_buffer.data(), m_buffer.data() + alignedSize, m_bufferFillLevel - alignedSize );
+        m_bufferFillLevel -= alignedSize;
+    }
+
+    void
+    checkedWrite( const void* const dataToWrite,
+                  const size_t      dataToWriteSize )
+    {
+        if ( const auto errorCode = writeAllToFd( m_fileDescriptor, dataToWrite, dataToWriteSize );
+             errorCode != 0 )
+        {
+            std::stringstream message;
+            message << "Failed to write all bytes because of: " << strerror( errorCode ) << " (" << errorCode << ")";
+            throw std::runtime_error( std::move( message ).str() );
+        }
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t BUFFER_SIZE = 1ULL << 20U;
+
+    int m_fileDescriptor{ -1 };
+    unique_file_descriptor m_ownedFd;
+    std::vector<char, AlignedAllocator<char, BLOCK_SIZE> > m_buffer;
+    size_t m_bufferFillLevel{ 0 };
+};
+#endif  // HAVE_O_DIRECT
+
+
 [[nodiscard]] inline std::ios_base::seekdir
 toSeekdir( int origin )
 {
@@ -50,6 +50,18 @@ public:
         m_threadPool( parallelization )
     {}
 
+    /** Scans for all given bit strings in a single pass. @see BitStringFinder */
+    ParallelBitStringFinder( UniqueFileReader      fileReader,
+                             std::vector<uint64_t> bitStringsToFind,
+                             size_t                parallelization = std::max( 1U, availableCores() / 8U ),
+                             size_t                requestedBytes = 0,
+                             size_t                fileBufferSizeBytes = 1_Mi ) :
+        BaseType( std::move( fileReader ),
+                  std::move( bitStringsToFind ),
+                  chunkSize( fileBufferSizeBytes, requestedBytes, parallelization ) ),
+        m_threadPool( parallelization )
+    {}
+
     /** @note This overload is used for the tests but can also be useful for other things. */
     ParallelBitStringFinder( const char* buffer,
                              size_t      size,
@@ -113,14 +125,18 @@ private:
      *                       bit offsets of interest.
      */
     static void
-    workerMain( char   const * const buffer,
-                size_t         const bufferSizeInBytes,
-                uint8_t        const firstBitsToIgnore,
-                uint64_t       const bitStringToFind,
-                size_t         const bitOffsetToAdd,
-                ThreadResults* const result )
+    workerMain( char                  const * const buffer,
+                size_t                        const bufferSizeInBytes,
+                uint8_t                       const firstBitsToIgnore,
+                std::vector<uint64_t> const &       bitStringsToFind,
+                size_t                        const bitOffsetToAdd,
+                ThreadResults*                const result )
     {
-        auto offsets = BaseType::findBitStrings( { buffer, bufferSizeInBytes }, bitStringToFind );
+        std::vector<size_t> offsets;
+        for ( const auto bitStringToFind : bitStringsToFind ) {
+            auto newOffsets = BaseType::findBitStrings( { buffer, bufferSizeInBytes }, bitStringToFind );
+            offsets.insert( offsets.end(), newOffsets.begin(), newOffsets.end() );
+        }
         std::sort( offsets.begin(), offsets.end() );
 
         std::lock_guard<std::mutex> lock( result->mutex );
@@ -252,7 +268,7 @@ ParallelBitStringFinder<bitStringSize>::find()
                         /* sub chunk buffer */ this->m_buffer.data() + bufferOffsetInBytes,
                         subChunkSizeInBytes,
                         subChunkOffsetInBits,
-                        this->m_bitStringToFind,
+                        this->m_bitStringsToFind,
                         ( this->m_nTotalBytesRead + bufferOffsetInBytes ) * CHAR_BIT,
                         &result
                     );
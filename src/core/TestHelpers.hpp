@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <filesystem>
 #include <mutex>
@@ -17,9 +20,15 @@
     #include <AvailabilityMacros.h>
 #endif
 
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+    #define TEST_HELPERS_WITH_AVX2
+    #include <immintrin.h>
+#endif
+
 
-int gnTests = 0;  // NOLINT
-int gnTestErrors = 0;  // NOLINT
+/* Atomic so that tests may check independent inputs from multiple threads. */
+std::atomic<int> gnTests{ 0 };  // NOLINT
+std::atomic<int> gnTestErrors{ 0 };  // NOLINT
 
 
 template<typename A,
@@ -62,6 +71,69 @@ require( bool               condition,
 } (), #condition, __LINE__ )  // NOLINT
 
 
+#ifdef TEST_HELPERS_WITH_AVX2
+/**
+ * Compares 32 bytes at a time and returns the position of the first mismatch inside a comparable
+ * 32 B block. If all full blocks match, returns the number of bytes compared so that the caller
+ * can finish the tail with the scalar loop.
+ */
+__attribute__(( target( "avx2" ) )) [[nodiscard]] inline size_t
+firstMismatchAVX2( const char* a,
+                   const char* b,
+                   size_t      size )
+{
+    size_t i = 0;
+    for ( ; i + sizeof( __m256i ) <= size; i += sizeof( __m256i ) ) {
+        const auto valuesA = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + i ) );
+        const auto valuesB = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + i ) );
+        const auto mismatches =
+            static_cast<uint32_t>( ~_mm256_movemask_epi8( _mm256_cmpeq_epi8( valuesA, valuesB ) ) );
+        if ( mismatches != 0 ) {
+            return i + static_cast<size_t>( __builtin_ctz( mismatches ) );
+        }
+    }
+    return i;
+}
+#endif  // TEST_HELPERS_WITH_AVX2
+
+
+/**
+ * Returns the position of the first differing byte or @p size if both buffers are equal.
+ * Tests compare decoded outputs against up to GiB-sized ground truths, so the common all-equal
+ * case is vectorized instead of looping per byte.
+ */
+[[nodiscard]] inline size_t
+firstMismatch( const void* a,
+               const void* b,
+               size_t      size )
+{
+    const auto* const bytesA = reinterpret_cast<const char*>( a );
+    const auto* const bytesB = reinterpret_cast<const char*>( b );
+
+    /* memcmp is the fastest whole-buffer equality check the platform offers, so the common
+     * all-equal case never enters the position-finding loops below. */
+    if ( std::memcmp( bytesA, bytesB, size ) == 0 ) {
+        return size;
+    }
+
+    size_t i = 0;
+#ifdef TEST_HELPERS_WITH_AVX2
+    static const bool avx2Supported = __builtin_cpu_supports( "avx2" ) != 0;
+    if ( avx2Supported ) {
+        /* Either the number of vectorized bytes without mismatch or a genuine mismatch position,
+         * which the scalar loop below then simply finds again immediately. */
+        i = firstMismatchAVX2( bytesA, bytesB, size );
+    }
+#endif
+    for ( ; i < size; ++i ) {
+        if ( bytesA[i] != bytesB[i] ) {
+            return i;
+        }
+    }
+    return size;
+}
+
+
 template<
     size_t   REPETITIONS,
     typename Functor,
@@ -70,6 +70,23 @@
     #define forceinline __attribute__(( always_inline )) inline
 #endif
 
+/**
+ * @ref hotfunction tells the compiler to optimize the function more aggressively and to group it with other
+ * hot code in the text section. @ref coldfunction does the opposite: the function is optimized for size,
+ * never inlined, and moved away from the hot text so that rarely taken paths such as buffer refills from
+ * the file and error handling do not pollute the instruction cache of the per-symbol decode loop.
+ */
+#if defined( __clang__ ) || defined( __GNUC__ )
+    #define hotfunction __attribute__(( hot ))
+    #define coldfunction __attribute__(( cold, noinline ))
+#elif defined( _MSC_VER )
+    #define hotfunction
+    #define coldfunction __declspec( noinline )
+#else
+    #define hotfunction
+    #define coldfunction
+#endif
+
 template<typename I1,
          typename I2,
          typename Enable = typename std::enable_if<
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <FileUtils.hpp>  // unique_file_descriptor
+
+#include "BufferView.hpp"
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+    #define HAVE_MMAP_FILE_READER
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+#ifdef HAVE_MMAP_FILE_READER
+/**
+ * Exposes a memory-mapped file through the FileReader interface. In contrast to StandardFileReader,
+ * reads copy straight out of the page cache without an intermediate read syscall per buffer refill.
+ * The file must be a regular seekable file, pipes and sockets cannot be mapped.
+ */
+class MMapFileReader :
+    public BufferViewFileReader
+{
+public:
+    /**
+     * SEQUENTIAL doubles the kernel readahead window and starts asynchronous readahead for the whole
+     * file, fitting front-to-back consumption. RANDOM disables readahead so that sparse probes, e.g.,
+     * verifying a few bytes per block, only fault in the pages actually touched; @ref prefetch can
+     * then request the known ranges explicitly.
+     */
+    enum class AccessPattern
+    {
+        SEQUENTIAL,
+        RANDOM,
+    };
+
+    explicit
+    MMapFileReader( const std::string& filePath,
+                    AccessPattern      accessPattern = AccessPattern::SEQUENTIAL ) :
+        MMapFileReader( mapFile( filePath, accessPattern ) )
+    {}
+
+    ~MMapFileReader() override
+    {
+        if ( m_mappedAddress != nullptr ) {
+            ::munmap( m_mappedAddress, m_mappedSize );
+        }
+    }
+
+    MMapFileReader( const MMapFileReader& ) = delete;
+    MMapFileReader( MMapFileReader&& ) = delete;
+    MMapFileReader& operator=( const MMapFileReader& ) = delete;
+    MMapFileReader& operator=( MMapFileReader&& ) = delete;
+
+    [[nodiscard]] const void*
+    data() const noexcept
+    {
+        return m_buffer;
+    }
+
+    /**
+     * Starts asynchronous readahead for the given byte range rounded out to page boundaries.
+     * Purely advisory, so failures can be ignored.
+     */
+    void
+    prefetch( [[maybe_unused]] const size_t offset,
+              [[maybe_unused]] const size_t size ) const
+    {
+    #ifdef POSIX_MADV_WILLNEED
+        if ( ( m_mappedAddress == nullptr ) || ( offset >= m_mappedSize ) ) {
+            return;
+        }
+        static const auto pageSize = static_cast<size_t>( ::sysconf( _SC_PAGESIZE ) );
+        const auto rangeBegin = offset - offset % pageSize;
+        const auto rangeEnd = std::min( m_mappedSize, offset + size );
+        ::posix_madvise( reinterpret_cast<char*>( m_mappedAddress ) + rangeBegin, rangeEnd - rangeBegin,
+                         POSIX_MADV_WILLNEED );
+    #endif
+    }
+
+private:
+    struct Mapping
+    {
+        void* address{ nullptr };
+        size_t size{ 0 };
+    };
+
+    explicit
+    MMapFileReader( const Mapping& mapping ) :
+        BufferViewFileReader( mapping.address, mapping.size ),
+        m_mappedAddress( mapping.address ),
+        m_mappedSize( mapping.size )
+    {}
+
+    [[nodiscard]] static Mapping
+    mapFile( const std::string&  filePath,
+             const AccessPattern accessPattern )
+    {
+        const unique_file_descriptor fileDescriptor( ::open( filePath.c_str(), O_RDONLY | O_CLOEXEC ) );
+        if ( *fileDescriptor < 0 ) {
+            throw std::invalid_argument( "Could not open file: " + filePath );
+        }
+
+        struct stat fileStatistics{};
+        if ( ::fstat( *fileDescriptor, &fileStatistics ) != 0 ) {
+            throw std::invalid_argument( "Could not stat file: " + filePath );
+        }
+        if ( !S_ISREG( fileStatistics.st_mode ) ) {
+            throw std::invalid_argument( "Can only memory-map regular files: " + filePath );
+        }
+
+        Mapping mapping;
+        mapping.size = static_cast<size_t>( fileStatistics.st_size );
+        if ( mapping.size == 0 ) {
+            /* mmap fails for empty files but an empty view is perfectly representable. */
+            return mapping;
+        }
+
+        mapping.address = ::mmap( nullptr, mapping.size, PROT_READ, MAP_PRIVATE, *fileDescriptor, 0 );
+        if ( mapping.address == MAP_FAILED ) {  // NOLINT(performance-no-int-to-ptr,cppcoreguidelines-pro-type-cstyle-cast)
+            throw std::invalid_argument( "Could not memory-map file: " + filePath );
+        }
+
+        /* All advice is, well, advisory, a failure does not hurt correctness,
+         * so the return values can be ignored. */
+        if ( accessPattern == AccessPattern::SEQUENTIAL ) {
+        #ifdef POSIX_MADV_SEQUENTIAL
+            /* Doubles the kernel readahead window. */
+            ::posix_madvise( mapping.address, mapping.size, POSIX_MADV_SEQUENTIAL );
+        #endif
+        #ifdef POSIX_MADV_WILLNEED
+            /* Start asynchronous readahead for the whole file. In contrast to MAP_POPULATE, this does
+             * not block until everything is resident, so the caller's work overlaps with the remaining
+             * I/O. */
+            ::posix_madvise( mapping.address, mapping.size, POSIX_MADV_WILLNEED );
+        #endif
+        } else {
+        #ifdef POSIX_MADV_RANDOM
+            ::posix_madvise( mapping.address, mapping.size, POSIX_MADV_RANDOM );
+        #endif
+        }
+        return mapping;
+    }
+
+private:
+    void* const m_mappedAddress;
+    const size_t m_mappedSize;
+};
+#endif  // HAVE_MMAP_FILE_READER
@@ -100,7 +100,12 @@ public:
     decode( BitReader& bitReader ) const
     {
         try {
-            const auto [length, symbol] = m_codeCache[bitReader.peek( m_lutBitsCount )];
+            /* The LUT only gets truncated for degenerate codings whose longest code is shorter than LUT_BITS_COUNT.
+             * Prefer the compile-time peek for the common full-sized case so that the bit mask becomes an immediate. */
+            const auto bits = LIKELY( m_lutBitsCount == LUT_BITS_COUNT )
+                              ? bitReader.template peek<LUT_BITS_COUNT>()
+                              : bitReader.peek( m_lutBitsCount );
+            const auto [length, symbol] = m_codeCache[bits];
             if ( length == 0 ) {
                 return decodeLong( bitReader );
             }
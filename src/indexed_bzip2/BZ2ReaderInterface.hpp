@@ -4,6 +4,7 @@
 #include <functional>
 #include <limits>
 #include <map>
+#include <vector>
 
 #include <filereader/FileReader.hpp>
 #include <FileUtils.hpp>                    // writeAll
@@ -31,7 +32,7 @@ public:
      * @param[out] outputBuffer should at least be large enough to hold @p nBytesToRead bytes
      * @return number of bytes written
      */
-    size_t
+    virtual size_t
     read( const int    outputFileDescriptor = -1,
           char* const  outputBuffer         = nullptr,
           const size_t nBytesToRead         = std::numeric_limits<size_t>::max() )
@@ -71,6 +72,38 @@ public:
     virtual std::map<size_t, size_t>
     blockOffsets() = 0;
 
+    /**
+     * Structure-of-arrays representation of @ref blockOffsets. The two index-aligned contiguous
+     * vectors iterate and dump cache-friendly, while walking the nodes of the tree-based map
+     * chases one heap pointer per block.
+     */
+    struct BlockOffsetsSoA
+    {
+        std::vector<size_t> encodedOffsetsInBits;
+        std::vector<size_t> decodedOffsetsInBytes;
+
+        [[nodiscard]] size_t
+        size() const
+        {
+            return encodedOffsetsInBits.size();
+        }
+    };
+
+    [[nodiscard]] virtual BlockOffsetsSoA
+    blockOffsetsSoA()
+    {
+        const auto offsets = blockOffsets();
+
+        BlockOffsetsSoA result;
+        result.encodedOffsetsInBits.reserve( offsets.size() );
+        result.decodedOffsetsInBytes.reserve( offsets.size() );
+        for ( const auto& [encodedOffset, decodedOffset] : offsets ) {
+            result.encodedOffsetsInBits.push_back( encodedOffset );
+            result.decodedOffsetsInBytes.push_back( decodedOffset );
+        }
+        return result;
+    }
+
     /**
      * Same as @ref blockOffsets but it won't force calculation of all blocks and simply returns
      * what is availabe at call time.
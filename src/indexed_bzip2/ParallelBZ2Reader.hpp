@@ -46,6 +46,11 @@ public:
 public:
     /* Constructors */
 
+    /**
+     * Non-seekable inputs such as pipes also work because @ref ensureSharedFileReader buffers them
+     * transparently with a SinglePassFileReader, so blocks can be decoded in parallel while the
+     * stream is still being read.
+     */
     explicit
     ParallelBZ2Reader( UniqueFileReader fileReader,
                        size_t           parallelization = 0 ) :
@@ -61,11 +66,7 @@ public:
                         m_finderParallelization
                 ) );
             } )
-    {
-        if ( !m_bitReader.seekable() ) {
-            throw std::invalid_argument( "Parallel BZ2 Reader will not work on non-seekable input like stdin (yet)!" );
-        }
-    }
+    {}
 
 #ifdef WITH_PYTHON_SUPPORT
     explicit
@@ -169,9 +170,76 @@ public:
 
     using BZ2ReaderInterface::read;
 
+    /**
+     * Like @ref WriteFunctor but additionally hands out the owning shared pointer of the block so that
+     * the consumer may extend the lifetime of the data beyond the call, e.g., for vmsplice.
+     */
+    using BlockWriteFunctor =
+        std::function<void ( const std::shared_ptr<BlockFetcher::BlockData>&,
+                             size_t /* offset in block */,
+                             size_t /* size to write */ )>;
+
+#ifdef HAVE_VMSPLICE
+    size_t
+    read( const int    outputFileDescriptor = -1,
+          char* const  outputBuffer         = nullptr,
+          const size_t nBytesToRead         = std::numeric_limits<size_t>::max() ) override
+    {
+        if ( ( outputFileDescriptor < 0 ) || ( outputBuffer != nullptr ) ) {
+            return BZ2ReaderInterface::read( outputFileDescriptor, outputBuffer, nBytesToRead );
+        }
+
+        /* Write the decoded blocks zero-copy into pipe outputs. The fetched blocks are held in shared
+         * pointers, so SpliceVault can extend their lifetime until the pipe buffer cannot reference the
+         * pages anymore. This is analogous to the ChunkData splice path in rapidgzip. */
+        const auto blockWriteFunctor =
+            [outputFileDescriptor, trySplice = true]
+            ( const std::shared_ptr<BlockFetcher::BlockData>& blockData,
+              size_t const                                    offsetInBlock,
+              size_t const                                    dataToWriteSize ) mutable
+            {
+                const auto* const dataToWrite = blockData->data.data() + offsetInBlock;
+
+                if ( trySplice ) {
+                    const auto [vault, lock] = SpliceVault::getInstance( outputFileDescriptor );
+                    if ( vault->splice( dataToWrite, dataToWriteSize, blockData ) == 0 ) {
+                        return;
+                    }
+                    /* Non-pipe output or splice error: write for the rest of the stream. */
+                    trySplice = false;
+                }
+
+                const auto errorCode = writeAllToFd( outputFileDescriptor, dataToWrite, dataToWriteSize );
+                if ( errorCode != 0 ) {
+                    std::stringstream message;
+                    message << "Failed to write all bytes because of: " << strerror( errorCode )
+                            << " (" << errorCode << ")";
+                    throw std::runtime_error( std::move( message ).str() );
+                }
+            };
+
+        return read( blockWriteFunctor, nBytesToRead );
+    }
+#endif  // HAVE_VMSPLICE
+
     size_t
     read( const WriteFunctor& writeFunctor,
           const size_t        nBytesToRead = std::numeric_limits<size_t>::max() ) override
+    {
+        const auto blockWriteFunctor =
+            [&writeFunctor]
+            ( const std::shared_ptr<BlockFetcher::BlockData>& blockData,
+              size_t const                                    offsetInBlock,
+              size_t const                                    dataToWriteSize )
+            {
+                writeFunctor( blockData->data.data() + offsetInBlock, dataToWriteSize );
+            };
+        return read( writeFunctor ? BlockWriteFunctor( blockWriteFunctor ) : BlockWriteFunctor(), nBytesToRead );
+    }
+
+    size_t
+    read( const BlockWriteFunctor& writeFunctor,
+          const size_t             nBytesToRead = std::numeric_limits<size_t>::max() )
     {
         if ( closed() ) {
             throw std::invalid_argument( "You may not call read on closed ParallelBZ2Reader!" );
@@ -263,7 +331,7 @@ public:
             const auto nBytesToDecode = std::min( blockData->data.size() - offsetInBlock,
                                                   nBytesToRead - nBytesDecoded );
             if ( writeFunctor ) {
-                writeFunctor( blockData->data.data() + offsetInBlock, nBytesToDecode );
+                writeFunctor( blockData, offsetInBlock, nBytesToDecode );
             }
 
             nBytesDecoded += nBytesToDecode;
@@ -354,6 +422,29 @@ public:
         return m_blockMap->blockOffsets();
     }
 
+    [[nodiscard]] BlockOffsetsSoA
+    blockOffsetsSoA() override
+    {
+        if ( !m_blockMap->finalized() ) {
+            read();
+            if ( !m_blockMap->finalized() || !blockFinder().finalized() ) {
+                throw std::logic_error( "Reading everything should have finalized the block map!" );
+            }
+        }
+
+        /* Converts straight from the contiguous block map storage without materializing a tree-based map. */
+        const auto offsets = m_blockMap->blockOffsetsVector();
+
+        BlockOffsetsSoA result;
+        result.encodedOffsetsInBits.reserve( offsets.size() );
+        result.decodedOffsetsInBytes.reserve( offsets.size() );
+        for ( const auto& [encodedOffset, decodedOffset] : offsets ) {
+            result.encodedOffsetsInBits.push_back( encodedOffset );
+            result.decodedOffsetsInBytes.push_back( decodedOffset );
+        }
+        return result;
+    }
+
     /**
      * Same as @ref blockOffsets but it won't force calculation of all blocks and simply returns
      * what is availabe at call time.
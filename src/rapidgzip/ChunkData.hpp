@@ -770,6 +770,11 @@ writeAll( const std::shared_ptr<ChunkData>& chunkData,
     if ( errorCode != 0 ) {
         return writeAllToFdVector( outputFileDescriptor, buffersToWrite );
     }
+#elif defined( HAVE_IOVEC )
+    /* Chunks with many back-references decay into many small fragments. Gathering them into one writev call
+     * (IOV_MAX segments at a time) instead of issuing one write syscall per fragment amortizes the syscall
+     * overhead over the whole chunk. */
+    return writeAllToFdVector( outputFileDescriptor, toIoVec( *chunkData, offsetInBlock, dataToWriteSize ) );
 #else
     using rapidgzip::deflate::DecodedData;
 
@@ -126,6 +126,12 @@ public:
         return std::accumulate( data.begin(), data.end(), size_t( 0 ), addSize );
     }
 
+    [[nodiscard]] size_t
+    dataSegmentCount() const noexcept
+    {
+        return data.size();
+    }
+
     [[nodiscard]] size_t
     dataWithMarkersSize() const noexcept
     {
@@ -532,6 +538,7 @@ toIoVec( const DecodedData& decodedData,
          const size_t       dataToWriteSize )
 {
     std::vector<::iovec> buffersToWrite;
+    buffersToWrite.reserve( decodedData.dataSegmentCount() );
     for ( auto it = rapidgzip::deflate::DecodedData::Iterator( decodedData, offsetInBlock, dataToWriteSize );
           static_cast<bool>( it ); ++it )
     {
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 
 #include <definitions.hpp>              // MAX_WINDOW_SIZE
 #include <VectorView.hpp>
 
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+    #define MARKER_REPLACEMENT_WITH_AVX2
+    #include <immintrin.h>
+#endif
+
 
 namespace rapidgzip::deflate
 {
@@ -46,13 +53,73 @@ private:
 };
 
 
+#ifdef MARKER_REPLACEMENT_WITH_AVX2
+/**
+ * Replaces 16 marker words per iteration for the full-window case. Literals keep their low byte,
+ * markers are resolved with a 32-bit gather into the padded window copy. Returns the number of
+ * processed elements. It stops early at the first vector containing a value that is neither a
+ * literal nor a valid marker so that the scalar code can throw with the exact diagnosis.
+ */
+__attribute__(( target( "avx2" ) )) [[nodiscard]] inline size_t
+replaceMarkerBytesFullWindowAVX2( uint16_t* const      buffer,
+                                  size_t const         size,
+                                  const uint8_t* const paddedWindow )
+{
+    constexpr size_t ELEMENTS_PER_VECTOR = sizeof( __m256i ) / sizeof( uint16_t );
+    const auto lowByteMask = _mm256_set1_epi32( 0xFF );
+
+    size_t i = 0;
+    for ( ; i + ELEMENTS_PER_VECTOR <= size; i += ELEMENTS_PER_VECTOR ) {
+        const auto values = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( buffer + i ) );
+        /* Literals have a zero high byte, markers have the sign bit set. Anything else is invalid. */
+        const auto literals = _mm256_cmpeq_epi16( _mm256_srli_epi16( values, 8 ), _mm256_setzero_si256() );
+        const auto markers = _mm256_srai_epi16( values, 15 );
+        if ( _mm256_movemask_epi8( _mm256_or_si256( literals, markers ) ) != -1 ) {
+            break;
+        }
+
+        /* Gather for all lanes. Literal lanes gather some unneeded byte, which the blend discards,
+         * and their indexes are small, so the gather stays inside the window. */
+        const auto indexes = _mm256_and_si256( values, _mm256_set1_epi16( 0x7FFF ) );
+        const auto indexesLow = _mm256_cvtepu16_epi32( _mm256_castsi256_si128( indexes ) );
+        const auto indexesHigh = _mm256_cvtepu16_epi32( _mm256_extracti128_si256( indexes, 1 ) );
+        const auto gatheredLow = _mm256_and_si256(
+            _mm256_i32gather_epi32( reinterpret_cast<const int*>( paddedWindow ), indexesLow, 1 ), lowByteMask );
+        const auto gatheredHigh = _mm256_and_si256(
+            _mm256_i32gather_epi32( reinterpret_cast<const int*>( paddedWindow ), indexesHigh, 1 ), lowByteMask );
+        /* packus interleaves the 128-bit lanes, the 64-bit permutation restores element order. */
+        const auto gathered = _mm256_permute4x64_epi64( _mm256_packus_epi32( gatheredLow, gatheredHigh ),
+                                                        0b1101'1000 );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( buffer + i ),
+                             _mm256_blendv_epi8( gathered, values, literals ) );
+    }
+    return i;
+}
+#endif  // MARKER_REPLACEMENT_WITH_AVX2
+
+
 inline void
 replaceMarkerBytes( WeakVector<std::uint16_t>       buffer,
                     VectorView<std::uint8_t> const& window )
 {
     /* For maximum size windows, we can skip one check because even UINT16_MAX is valid. */
     if ( window.size() >= MAX_WINDOW_SIZE ) {
-        std::transform( buffer.begin(), buffer.end(), buffer.begin(), MapMarkers<true>( window ) );
+        size_t replaced{ 0 };
+    #ifdef MARKER_REPLACEMENT_WITH_AVX2
+        static const bool avx2Supported = __builtin_cpu_supports( "avx2" ) != 0;
+        /* The window copy below costs 32 KiB, so only vectorize when enough lookups amortize it. */
+        if ( avx2Supported && ( buffer.size() * sizeof( uint16_t ) >= MAX_WINDOW_SIZE ) ) {
+            /* The gather loads 4 B per lookup, so the window is copied once into a padded buffer
+             * to keep lookups of the highest marker values from reading past its end. */
+            std::array<uint8_t, MAX_WINDOW_SIZE + sizeof( uint32_t )> paddedWindow;
+            std::memcpy( paddedWindow.data(), window.data(), MAX_WINDOW_SIZE );
+            std::memset( paddedWindow.data() + MAX_WINDOW_SIZE, 0, sizeof( uint32_t ) );
+            replaced = replaceMarkerBytesFullWindowAVX2( buffer.data(), buffer.size(), paddedWindow.data() );
+        }
+    #endif
+        std::transform( buffer.begin() + static_cast<std::ptrdiff_t>( replaced ), buffer.end(),
+                        buffer.begin() + static_cast<std::ptrdiff_t>( replaced ),
+                        MapMarkers<true>( window ) );
     } else {
         std::transform( buffer.begin(), buffer.end(), buffer.begin(), MapMarkers<false>( window ) );
     }
@@ -12,6 +12,7 @@
 #include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -64,6 +65,26 @@ wrapFileReader( UniqueFileReader&& fileReader,
 #endif  // WITH_PYTHON_SUPPORT
 
 
+/**
+ * Returns true when the given write functor stands for "discard the data", i.e., it is a nullptr literal or
+ * an empty std::function. Arbitrary (lambda) functors are always considered valid so that @ref
+ * ParallelGzipReader::read can be templated on the concrete functor type without requiring a conversion
+ * to a type-erased std::function, which would prohibit inlining of the write body.
+ */
+template<typename WriteFunctor>
+[[nodiscard]] constexpr bool
+isNullWriteFunctor( const WriteFunctor& writeFunctor )
+{
+    if constexpr ( std::is_null_pointer_v<WriteFunctor> ) {
+        return true;
+    } else if constexpr ( std::is_constructible_v<bool, const WriteFunctor&> ) {
+        return !static_cast<bool>( writeFunctor );
+    } else {
+        return false;
+    }
+}
+
+
 /**
  * @note Calls to this class are not thread-safe! Even though they use threads to evaluate them in parallel.
  */
@@ -496,7 +517,7 @@ public:
           char* const  outputBuffer         = nullptr,
           const size_t nBytesToRead         = std::numeric_limits<size_t>::max() )
     {
-        const auto writeFunctor =
+        auto writeFunctor =
             [nBytesDecoded = uint64_t( 0 ), outputFileDescriptor, outputBuffer]
             ( const std::shared_ptr<ChunkData>& chunkData,
               size_t const                      offsetInBlock,
@@ -532,17 +553,23 @@ public:
             };
 
         if ( ( outputFileDescriptor == -1 ) && ( outputBuffer == nullptr ) ) {
-            /* An empty std::function gives that read method options to optimize, e.g., via seeking. */
-            return read( WriteFunctor{}, nBytesToRead );
+            /* A null functor gives that read method options to optimize, e.g., via seeking. */
+            return read( nullptr, nBytesToRead );
         }
         return read( writeFunctor, nBytesToRead );
     }
 
+    /**
+     * The functor type is a template parameter instead of @ref WriteFunctor so that concrete lambdas can be
+     * passed through without type-erasure, which would cost an indirect call per chunk and prohibit inlining
+     * the write body into this loop. A nullptr or empty std::function skips the data as fast as possible.
+     */
+    template<typename WriteFunctorType = WriteFunctor>
     size_t
-    read( const WriteFunctor& writeFunctor,
-          const size_t        nBytesToRead = std::numeric_limits<size_t>::max() )
+    read( WriteFunctorType&& writeFunctor,
+          const size_t       nBytesToRead = std::numeric_limits<size_t>::max() )
     {
-        if ( !writeFunctor && m_blockMap->finalized() ) {
+        if ( isNullWriteFunctor( writeFunctor ) && m_blockMap->finalized() ) {
             const auto oldOffset = tell();
             const auto newOffset = seek( nBytesToRead > static_cast<size_t>( std::numeric_limits<long long int>::max() )
                                          ? std::numeric_limits<long long int>::max()
@@ -604,11 +631,13 @@ public:
                 m_crc32Time += duration( tCRC32Start );
             }
 
-            if ( writeFunctor ) {
-                [[maybe_unused]] const auto tWriteStart = now();
-                writeFunctor( chunkData, offsetInBlock, nBytesToDecode );
-                if ( m_statisticsEnabled ) {
-                    m_writeOutputTime += duration( tWriteStart );
+            if constexpr ( !std::is_null_pointer_v<std::decay_t<WriteFunctorType> > ) {
+                if ( !isNullWriteFunctor( writeFunctor ) ) {
+                    [[maybe_unused]] const auto tWriteStart = now();
+                    writeFunctor( chunkData, offsetInBlock, nBytesToDecode );
+                    if ( m_statisticsEnabled ) {
+                        m_writeOutputTime += duration( tWriteStart );
+                    }
                 }
             }
 
@@ -725,6 +754,23 @@ public:
         return m_blockMap->blockOffsets();
     }
 
+    /**
+     * Same as @ref blockOffsets but returns the offset pairs as the contiguous vector in which they are
+     * stored internally, which is preferable for read-only traversal.
+     */
+    [[nodiscard]] BlockMap::BlockOffsets
+    blockOffsetsVector()
+    {
+        if ( !m_blockMap->finalized() ) {
+            read();
+            if ( !m_blockMap->finalized() || !blockFinder().finalized() ) {
+                throw std::logic_error( "Reading everything should have finalized the block map!" );
+            }
+        }
+
+        return m_blockMap->blockOffsetsVector();
+    }
+
     /**
      * This is the first instance for me where returning a const value makes sense because it contains
      * a shared pointer to the WindowMap, which is not to be modified. Making GzipIndex const forces
@@ -74,6 +74,31 @@ public:
         }
     }
 
+    /**
+     * Inserts many windows while taking the lock and locating the insertion position only once.
+     * The same rules as for @ref emplaceShared apply to each element, i.e., null windows are skipped and
+     * existing offsets are overwritten. When the offsets are sorted and larger than all existing ones,
+     * which is the common case of importing an index, every insertion degrades to an O(1) append thanks
+     * to the always-perfect emplace hint.
+     */
+    void
+    emplaceSharedBatch( const std::vector<std::pair</* encoded block offset */ size_t, SharedWindow> >& sharedWindows )
+    {
+        std::scoped_lock lock( m_mutex );
+
+        for ( const auto& [encodedBlockOffset, sharedWindow] : sharedWindows ) {
+            if ( !sharedWindow ) {
+                continue;
+            }
+
+            if ( m_windows.empty() || ( m_windows.rbegin()->first < encodedBlockOffset ) ) {
+                m_windows.emplace_hint( m_windows.end(), encodedBlockOffset, sharedWindow );
+            } else {
+                m_windows.insert_or_assign( m_windows.end(), encodedBlockOffset, sharedWindow );
+            }
+        }
+    }
+
     [[nodiscard]] SharedWindow
     get( size_t encodedOffsetInBits ) const
     {
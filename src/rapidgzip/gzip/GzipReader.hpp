@@ -10,6 +10,7 @@
 #include <string_view>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include <crc32.hpp>
 #include <DecodedDataView.hpp>
@@ -20,6 +21,10 @@
 #include <filereader/Standard.hpp>
 #include <gzip.hpp>
 
+#ifdef WITH_ISAL
+    #include "isal.hpp"
+#endif
+
 #ifdef WITH_PYTHON_SUPPORT
     #include <filereader/Python.hpp>
 #endif
@@ -38,11 +43,30 @@ public:
     using DeflateBlock = typename deflate::Block<>;
     using WriteFunctor = std::function<void ( const void*, uint64_t )>;
 
+    /**
+     * Selects the inflate implementation. ISAL bulk-decodes with the vendored ISA-L, which is
+     * multiple times faster than the native decoder but only supports plain full-stream reads.
+     * Stopping points require NATIVE because only the native decoder tracks deflate block state.
+     */
+    enum class Backend
+    {
+        NATIVE,
+        ISAL,
+    };
+
 public:
     explicit
-    GzipReader( UniqueFileReader fileReader ) :
-        m_bitReader( std::move( fileReader ) )
-    {}
+    GzipReader( UniqueFileReader fileReader,
+                Backend          backend = Backend::NATIVE ) :
+        m_bitReader( std::move( fileReader ) ),
+        m_backend( backend )
+    {
+    #ifndef WITH_ISAL
+        if ( m_backend == Backend::ISAL ) {
+            throw std::invalid_argument( "This build was compiled without ISA-L. Use Backend::NATIVE!" );
+        }
+    #endif
+    }
 
 #ifdef WITH_PYTHON_SUPPORT
     explicit
@@ -145,6 +169,29 @@ public:
 
     /* Gzip specific methods */
 
+    /**
+     * Rebinds the reader to another file and clears all decoding state. This allows reusing one
+     * instance for many inputs, e.g., in test or benchmark loops over small samples, instead of
+     * reconstructing the whole reader per input.
+     */
+    void
+    reset( UniqueFileReader fileReader )
+    {
+        m_bitReader.reset( std::move( fileReader ) );
+        m_currentPosition = 0;
+        m_atEndOfFile = false;
+        m_lastGzipHeader = {};
+        m_currentDeflateBlock.reset();
+        m_lastBlockData = {};
+        m_currentPoint = END_OF_STREAM;
+        m_streamBytesCount = 0;
+        m_offsetInLastBuffers.reset();
+        m_crc32Calculator.reset();
+    #ifdef WITH_ISAL
+        m_inflateWrapper.reset();
+    #endif
+    }
+
     /**
      * @return number of processed bits of compressed input file stream.
      * @note It's only useful for a rough estimate because of buffering and because deflate is block based.
@@ -152,6 +199,12 @@ public:
     [[nodiscard]] size_t
     tellCompressed() const
     {
+    #ifdef WITH_ISAL
+        /* The wrapper owns a copy of the bit reader, so m_bitReader does not advance with it. */
+        if ( m_inflateWrapper.has_value() ) {
+            return m_inflateWrapper->tellCompressed();
+        }
+    #endif
         return m_bitReader.tell();
     }
 
@@ -208,6 +261,15 @@ public:
           const size_t        nBytesToRead = std::numeric_limits<size_t>::max(),
           const StoppingPoint stoppingPoints = StoppingPoint::NONE )
     {
+    #ifdef WITH_ISAL
+        if ( m_backend == Backend::ISAL ) {
+            if ( stoppingPoints != StoppingPoint::NONE ) {
+                throw std::invalid_argument( "Stopping points are only supported with Backend::NATIVE!" );
+            }
+            return readWithIsal( writeFunctor, nBytesToRead );
+        }
+    #endif
+
         size_t nBytesDecoded = 0;
 
         /* This loop is basically a state machine over m_currentPoint and will process different things
@@ -318,6 +380,16 @@ private:
     readBlock( const WriteFunctor& writeFunctor,
                size_t              nMaxBytesToDecode );
 
+#ifdef WITH_ISAL
+    /**
+     * Bulk-decodes with ISA-L, bypassing the native block state machine. CRC32 and stream size are
+     * still verified against each gzip footer just like the native path does.
+     */
+    size_t
+    readWithIsal( const WriteFunctor& writeFunctor,
+                  size_t              nBytesToRead );
+#endif
+
     void
     readGzipHeader()
     {
@@ -384,6 +456,14 @@ private:
     std::optional<size_t> m_offsetInLastBuffers;
 
     CRC32Calculator m_crc32Calculator;
+
+    const Backend m_backend{ Backend::NATIVE };
+#ifdef WITH_ISAL
+    /** Created lazily on the first read so that reset() can rebind to another file beforehand. */
+    std::optional<IsalInflateWrapper> m_inflateWrapper;
+    /** Staging buffer for the write functor. Same size as IsalInflateWrapper's input buffer. */
+    std::vector<char> m_isalOutputBuffer;
+#endif
 };
 
 
@@ -490,6 +570,59 @@ GzipReader::readBlock( const WriteFunctor& writeFunctor,
 }
 
 
+#ifdef WITH_ISAL
+inline size_t
+GzipReader::readWithIsal( const WriteFunctor& writeFunctor,
+                          const size_t        nBytesToRead )
+{
+    if ( !m_inflateWrapper.has_value() ) {
+        m_inflateWrapper.emplace( BitReader( m_bitReader ) );
+        m_inflateWrapper->setFileType( FileType::GZIP );
+        m_inflateWrapper->setStartWithHeader( true );
+        /* Decoding into overly large buffers in one go is slower than chunking, see the note
+         * on the input buffer in IsalInflateWrapper. */
+        m_isalOutputBuffer.resize( 128_Ki );
+    }
+
+    size_t nBytesDecoded{ 0 };
+    while ( ( nBytesDecoded < nBytesToRead ) && !eof() ) {
+        const auto nBytesToDecode = std::min( m_isalOutputBuffer.size(), nBytesToRead - nBytesDecoded );
+        const auto [nBytesRead, footer] = m_inflateWrapper->readStream(
+            reinterpret_cast<uint8_t*>( m_isalOutputBuffer.data() ), nBytesToDecode );
+
+        if ( nBytesRead > 0 ) {
+            m_crc32Calculator.update( m_isalOutputBuffer.data(), nBytesRead );
+            if ( writeFunctor ) {
+                writeFunctor( m_isalOutputBuffer.data(), nBytesRead );
+            }
+            nBytesDecoded += nBytesRead;
+            m_streamBytesCount += nBytesRead;
+        }
+
+        if ( footer.has_value() ) {
+            /* readStream returns at each stream end, so all bytes of this call belong to the
+             * stream the footer terminates. Verify it like readGzipFooter does. */
+            if ( static_cast<uint32_t>( m_streamBytesCount ) != footer->gzipFooter.uncompressedSize ) {
+                std::stringstream message;
+                message << "Mismatching size (" << static_cast<uint32_t>( m_streamBytesCount ) << " <-> footer: "
+                        << footer->gzipFooter.uncompressedSize << ") for gzip stream!";
+                throw std::domain_error( std::move( message ).str() );
+            }
+            m_crc32Calculator.verify( footer->gzipFooter.crc32 );
+            m_crc32Calculator.reset();
+            m_streamBytesCount = 0;
+        } else if ( nBytesRead == 0 ) {
+            /* Neither data nor a footer means that there is no further gzip stream. */
+            m_atEndOfFile = true;
+        }
+    }
+
+    m_currentPosition += nBytesDecoded;
+    return nBytesDecoded;
+}
+#endif  // WITH_ISAL
+
+
 inline void
 GzipReader::readGzipFooter()
 {
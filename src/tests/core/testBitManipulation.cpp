@@ -47,6 +47,15 @@ nLowestBitsSet64()
 }
 
 
+/* The if constexpr chain in the compile-time overload must fold to literals even for the zero and
+ * full-width edge cases, which would be undefined behavior with a plain ( 1 << N ) - 1. */
+static_assert( nLowestBitsSet<uint8_t, 0>() == uint8_t( 0 ) );
+static_assert( nLowestBitsSet<uint8_t, 8>() == uint8_t( 0xFFU ) );
+static_assert( nLowestBitsSet<uint32_t, 32>() == 0xFFFF'FFFFUL );
+static_assert( nLowestBitsSet<uint64_t, 63>() == 0x7FFF'FFFF'FFFF'FFFFULL );
+static_assert( nLowestBitsSet<uint64_t, 64>() == 0xFFFF'FFFF'FFFF'FFFFULL );
+
+
 template<uint8_t bitsSet>
 uint8_t
 nHighestBitsSet8()
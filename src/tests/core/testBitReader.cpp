@@ -1,39 +1,55 @@
+#include <array>
 #include <cstdint>
 #include <cstdio>
 #include <iostream>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <common.hpp>
 #include <BitManipulation.hpp>
 #include <BitReader.hpp>
 #include <filereader/Buffered.hpp>
+#include <filereader/MemoryMap.hpp>
 #include <filereader/Standard.hpp>
 #include <TestHelpers.hpp>
 
 
+/**
+ * Checks a golden sequence of bit counts and expected values in one loop instead of one REQUIRE statement
+ * per read, which keeps the object code of the hand-written test bodies small. Each value is checked via
+ * peek before it is consumed by read and the bit offset must advance accordingly.
+ */
+template<bool     MOST_SIGNIFICANT_BITS_FIRST,
+         typename BitBuffer,
+         size_t   N>
+void
+checkPeeksAndReads( BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>&  bitReader,
+                    const std::array<std::pair<uint8_t, uint64_t>, N>&  goldenReads )
+{
+    for ( const auto& [bitCount, expected] : goldenReads ) {
+        const auto offsetBefore = bitReader.tell();
+        REQUIRE_EQUAL( bitReader.peek( bitCount ), expected );
+        REQUIRE_EQUAL( bitReader.read( bitCount ), expected );
+        REQUIRE_EQUAL( bitReader.tell(), offsetBefore + bitCount );
+    }
+}
+
+
 void
 testMSBBitReader()
 {
-    const std::vector<char> fileContents = {
+    static constexpr std::array<char, 5> fileContents = {
         /*       0x5A                0xAA               0x0F               0x0F               0x0F */
         (char)0b0101'1010, (char)0b1010'1010, (char)0b0000'1111, (char)0b0000'1111, (char)0b0000'1111
     };
-    BitReader<true, uint64_t> bitReader( std::make_unique<BufferedFileReader>( fileContents ) );
+    BitReader<true, uint64_t> bitReader( std::make_unique<BufferViewFileReader>( fileContents.data(), fileContents.size() ) );
 
     REQUIRE( bitReader.read<0>() == 0b0UL );
-    REQUIRE( bitReader.read<1>() == 0b0UL );
-    REQUIRE( bitReader.tell() == 1 );
-    REQUIRE( bitReader.read<1>() == 0b1UL );
-    REQUIRE( bitReader.tell() == 2 );
-    REQUIRE( bitReader.read<2>() == 0b01UL );
-    REQUIRE( bitReader.tell() == 4 );
-    REQUIRE( bitReader.read<4>() == 0b1010UL );
-    REQUIRE( bitReader.tell() == 8 );
-    REQUIRE( bitReader.read<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.tell() == 16 );
-    REQUIRE( bitReader.read<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.tell() == 24 );
+    static constexpr std::array<std::pair<uint8_t, uint64_t>, 6> goldenReads = { {
+        { 1, 0b0 }, { 1, 0b1 }, { 2, 0b01 }, { 4, 0b1010 }, { 8, 0b1010'1010 }, { 8, 0b0000'1111 },
+    } };
+    checkPeeksAndReads( bitReader, goldenReads );
 
     REQUIRE( bitReader.seek( 0, SEEK_SET ) == 0 );
     REQUIRE( bitReader.tell() == 0 );
@@ -90,25 +106,17 @@ testMSBBitReader()
 void
 testLSBBitReader()
 {
-    const std::vector<char> fileContents = {
+    static constexpr std::array<char, 5> fileContents = {
         /*       0x5A                0xAA               0x0F               0x0F               0x0F    */
         (char)0b0101'1010, (char)0b1010'1010, (char)0b0000'1111, (char)0b0000'1111, (char)0b0000'1111
     };
-    BitReader<false, uint64_t> bitReader( std::make_unique<BufferedFileReader>( fileContents ) );
+    BitReader<false, uint64_t> bitReader( std::make_unique<BufferViewFileReader>( fileContents.data(), fileContents.size() ) );
 
     REQUIRE( bitReader.read<0>() == 0b0UL );
-    REQUIRE( bitReader.read<1>() == 0b0UL );
-    REQUIRE( bitReader.tell() == 1 );
-    REQUIRE( bitReader.read<1>() == 0b1UL );
-    REQUIRE( bitReader.tell() == 2 );
-    REQUIRE( bitReader.read<2>() == 0b10UL );
-    REQUIRE( bitReader.tell() == 4 );
-    REQUIRE( bitReader.read<4>() == 0b0101UL );
-    REQUIRE( bitReader.tell() == 8 );
-    REQUIRE( bitReader.read<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.tell() == 16 );
-    REQUIRE( bitReader.read<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.tell() == 24 );
+    static constexpr std::array<std::pair<uint8_t, uint64_t>, 6> goldenReads = { {
+        { 1, 0b0 }, { 1, 0b1 }, { 2, 0b10 }, { 4, 0b0101 }, { 8, 0b1010'1010 }, { 8, 0b0000'1111 },
+    } };
+    checkPeeksAndReads( bitReader, goldenReads );
 
     REQUIRE( bitReader.seek( 0, SEEK_SET ) == 0 );
     REQUIRE( bitReader.tell() == 0 );
@@ -166,33 +174,19 @@ testLSBBitReader()
 void
 testMSBBitReaderPeek()
 {
-    const std::vector<char> fileContents = {
+    static constexpr std::array<char, 5> fileContents = {
         /*       0x5A                0xAA               0x0F               0x0F               0x0F */
         (char)0b0101'1010, (char)0b1010'1010, (char)0b0000'1111, (char)0b0000'1111, (char)0b0000'1111
     };
     /* Bit buffer must be uint64_t or else the peek 32-bits might feel if it is not aligned to byte boundary! */
-    BitReader<true, uint64_t> bitReader( std::make_unique<BufferedFileReader>( fileContents ) );
+    BitReader<true, uint64_t> bitReader( std::make_unique<BufferViewFileReader>( fileContents.data(), fileContents.size() ) );
 
     REQUIRE( bitReader.peek<0>() == 0b0UL );
     REQUIRE( bitReader.read<0>() == 0b0UL );
-    REQUIRE( bitReader.peek<1>() == 0b0UL );
-    REQUIRE( bitReader.read<1>() == 0b0UL );
-    REQUIRE( bitReader.tell() == 1 );
-    REQUIRE( bitReader.peek<1>() == 0b1UL );
-    REQUIRE( bitReader.read<1>() == 0b1UL );
-    REQUIRE( bitReader.tell() == 2 );
-    REQUIRE( bitReader.peek<2>() == 0b01UL );
-    REQUIRE( bitReader.read<2>() == 0b01UL );
-    REQUIRE( bitReader.tell() == 4 );
-    REQUIRE( bitReader.peek<4>() == 0b1010UL );
-    REQUIRE( bitReader.read<4>() == 0b1010UL );
-    REQUIRE( bitReader.tell() == 8 );
-    REQUIRE( bitReader.peek<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.read<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.tell() == 16 );
-    REQUIRE( bitReader.peek<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.read<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.tell() == 24 );
+    static constexpr std::array<std::pair<uint8_t, uint64_t>, 6> goldenReads = { {
+        { 1, 0b0 }, { 1, 0b1 }, { 2, 0b01 }, { 4, 0b1010 }, { 8, 0b1010'1010 }, { 8, 0b0000'1111 },
+    } };
+    checkPeeksAndReads( bitReader, goldenReads );
 
     REQUIRE( bitReader.seek( 0, SEEK_SET ) == 0 );
     REQUIRE( bitReader.tell() == 0 );
@@ -258,33 +252,19 @@ testMSBBitReaderPeek()
 void
 testLSBBitReaderPeek()
 {
-    const std::vector<char> fileContents = {
+    static constexpr std::array<char, 5> fileContents = {
         /*       0x5A                0xAA               0x0F               0x0F               0x0F    */
         (char)0b0101'1010, (char)0b1010'1010, (char)0b0000'1111, (char)0b0000'1111, (char)0b0000'1111
     };
     /* Bit buffer must be uint64_t or else the peek 32-bits might feel if it is not aligned to byte boundary! */
-    BitReader<false, uint64_t> bitReader( std::make_unique<BufferedFileReader>( fileContents ) );
+    BitReader<false, uint64_t> bitReader( std::make_unique<BufferViewFileReader>( fileContents.data(), fileContents.size() ) );
 
     REQUIRE( bitReader.peek<0>() == 0b0UL );
     REQUIRE( bitReader.read<0>() == 0b0UL );
-    REQUIRE( bitReader.peek<1>() == 0b0UL );
-    REQUIRE( bitReader.read<1>() == 0b0UL );
-    REQUIRE( bitReader.tell() == 1 );
-    REQUIRE( bitReader.peek<1>() == 0b1UL );
-    REQUIRE( bitReader.read<1>() == 0b1UL );
-    REQUIRE( bitReader.tell() == 2 );
-    REQUIRE( bitReader.peek<2>() == 0b10UL );
-    REQUIRE( bitReader.read<2>() == 0b10UL );
-    REQUIRE( bitReader.tell() == 4 );
-    REQUIRE( bitReader.peek<4>() == 0b0101UL );
-    REQUIRE( bitReader.read<4>() == 0b0101UL );
-    REQUIRE( bitReader.tell() == 8 );
-    REQUIRE( bitReader.peek<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.read<8>() == 0b1010'1010UL );
-    REQUIRE( bitReader.tell() == 16 );
-    REQUIRE( bitReader.peek<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.read<8>() == 0b0000'1111UL );
-    REQUIRE( bitReader.tell() == 24 );
+    static constexpr std::array<std::pair<uint8_t, uint64_t>, 6> goldenReads = { {
+        { 1, 0b0 }, { 1, 0b1 }, { 2, 0b10 }, { 4, 0b0101 }, { 8, 0b1010'1010 }, { 8, 0b0000'1111 },
+    } };
+    checkPeeksAndReads( bitReader, goldenReads );
 
     REQUIRE( bitReader.seek( 0, SEEK_SET ) == 0 );
     REQUIRE( bitReader.tell() == 0 );
@@ -375,6 +355,52 @@ testSequentialReading( const size_t nBitsToReadPerCall )
 }
 
 
+template<bool     MOST_SIGNIFICANT_BITS_FIRST,
+         typename BitBuffer>
+void
+testReadingAcrossBufferEnds( const size_t nBitsToReadPerCall )
+{
+    /* Deterministic pseudo-random contents so that wrongly ordered or duplicated bits are detected. */
+    std::vector<char> fileContents( 67 );
+    uint8_t state{ 0x5A };
+    for ( auto& byte : fileContents ) {
+        state = static_cast<uint8_t>( state * 137U + 41U );
+        byte = static_cast<char>( state );
+    }
+
+    const auto referenceBit =
+        [&fileContents] ( const size_t offsetBits ) -> uint64_t
+        {
+            const auto byte = static_cast<uint8_t>( fileContents[offsetBits / CHAR_BIT] );
+            if constexpr ( MOST_SIGNIFICANT_BITS_FIRST ) {
+                return ( byte >> ( CHAR_BIT - 1U - ( offsetBits % CHAR_BIT ) ) ) & 1U;
+            } else {
+                return ( byte >> ( offsetBits % CHAR_BIT ) ) & 1U;
+            }
+        };
+
+    /* A tiny refill size forces many byte buffer refills, which exercises the byte-wise fallback at the
+     * buffer ends in addition to the bulk bit buffer refill in the middle. */
+    BitReader<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer> bitReader(
+        std::make_unique<BufferedFileReader>( fileContents ), /* refill size */ 11 );
+
+    const auto fileSizeBits = fileContents.size() * CHAR_BIT;
+    for ( size_t offset = 0; offset + nBitsToReadPerCall <= fileSizeBits; offset += nBitsToReadPerCall ) {
+        uint64_t expected{ 0 };
+        for ( size_t i = 0; i < nBitsToReadPerCall; ++i ) {
+            if constexpr ( MOST_SIGNIFICANT_BITS_FIRST ) {
+                expected = ( expected << 1U ) | referenceBit( offset + i );
+            } else {
+                expected |= referenceBit( offset + i ) << i;
+            }
+        }
+
+        REQUIRE_EQUAL( bitReader.read( nBitsToReadPerCall ), expected );
+        REQUIRE_EQUAL( bitReader.tell(), offset + nBitsToReadPerCall );
+    }
+}
+
+
 enum class FastPath
 {
     BIT_BUFFER_SEEK,
@@ -484,6 +510,7 @@ testBitReader()
 {
     for ( const auto nBitsToReadPerCall : { 1, 2, 3, 15, 16, 31, 32, 48, 63 } ) {
         testSequentialReading<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>( nBitsToReadPerCall );
+        testReadingAcrossBufferEnds<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer>( nBitsToReadPerCall );
     }
 
     testBufferSeekingFastPaths<MOST_SIGNIFICANT_BITS_FIRST, BitBuffer, FastPath::BIT_BUFFER_SEEK>();
@@ -495,14 +522,13 @@ testBitReader()
 
 
 void
-testDirectFileReadingBitReaderBug( const std::filesystem::path& path )
+testDirectFileReadingBitReaderBug( UniqueFileReader fileReader )
 {
     /* This test is intended to work with random-128KiB.gz, but it should work with any file that is
      * greater than 128 KiB (BitReader byte buffer size) and that has mostly different bytes so that
      * the check that compares the read bytes at position 128_Ki - 1 after seeking forward and after
      * seeking back fails. */
-    BitReader<false, uint64_t> bitReader( std::make_unique<StandardFileReader>( path.string() ),
-                                          /* byte buffer size */ 128_Ki );
+    BitReader<false, uint64_t> bitReader( std::move( fileReader ), /* byte buffer size */ 128_Ki );
 
     static constexpr size_t GZIP_HEADER_SIZE = 0;
     bitReader.seek( GZIP_HEADER_SIZE * CHAR_BIT );
@@ -564,7 +590,12 @@ main( int    argc,
             findParentFolderContaining( binaryFolder, "src/tests/data/random-128KiB.gz" )
         ) / "src" / "tests" / "data";
 
-    testDirectFileReadingBitReaderBug( testFolder / "random-128KiB.gz" );
+    const auto testFilePath = ( testFolder / "random-128KiB.gz" ).string();
+    testDirectFileReadingBitReaderBug( std::make_unique<StandardFileReader>( testFilePath ) );
+#ifdef HAVE_MMAP_FILE_READER
+    /* The same expectations must hold when the file contents come out of a zero-copy file mapping. */
+    testDirectFileReadingBitReaderBug( std::make_unique<MMapFileReader>( testFilePath ) );
+#endif
 
     std::cout << "Tests successful: " << ( gnTests - gnTestErrors ) << " / " << gnTests << "\n";
 
@@ -15,6 +15,7 @@
 #include <BitStringFinder.hpp>
 #include <common.hpp>
 #include <DataGenerators.hpp>
+#include <filereader/MemoryMap.hpp>
 #include <filereader/Standard.hpp>
 #include <FileUtils.hpp>
 #include <ParallelBZ2Reader.hpp>
@@ -45,15 +46,31 @@ void
 testDecodingBz2ForFirstTime( const std::string& decodedTestFilePath,
                              const std::string& encodedTestFilePath )
 {
-    size_t decodedFileSize = 0;
-    {
-        std::ifstream file( decodedTestFilePath );
-        file.seekg( 0, std::ios::end );
-        decodedFileSize = file.tellg();
-    }
+#ifdef HAVE_MMAP_FILE_READER
+    /* Map the ground truth once. Each mirrored read then compares straight out of the page cache
+     * instead of issuing a seekg and read syscall pair plus a copy into a comparison buffer,
+     * which matters for the reads requesting up to the whole decoded file. */
+    const MMapFileReader decodedFile( decodedTestFilePath );
+    const auto* const groundTruth = reinterpret_cast<const char*>( decodedFile.data() );
+    const auto decodedFileSize = decodedFile.size().value();
+#else
+    std::vector<char> groundTruthBuffer( fileSize( decodedTestFilePath ) );
+    std::ifstream decodedFile( decodedTestFilePath );
+    decodedFile.read( groundTruthBuffer.data(), static_cast<std::ptrdiff_t>( groundTruthBuffer.size() ) );
+    REQUIRE( static_cast<size_t>( decodedFile.gcount() ) == groundTruthBuffer.size() );
+    const auto* const groundTruth = groundTruthBuffer.data();
+    const auto decodedFileSize = groundTruthBuffer.size();
+#endif
     std::cerr << "Decoded file size: " << decodedFileSize << "\n";
 
-    std::ifstream decodedFile( decodedTestFilePath );
+    /* Position and eof state into the ground truth, mirroring BZ2Reader semantics: the position is
+     * clamped into [0, decodedFileSize], eof is set by reading or seeking beyond the end and cleared
+     * by seeking before it. This models the reference semantics directly instead of translating from
+     * std::ifstream, whose fail bit, unclamped tellg, and eof-less overlong seeks previously required
+     * special cases around each comparison and made the seek eof comparison impossible. */
+    size_t decodedPosition{ 0 };
+    bool decodedEof{ false };
+
     auto encodedFile =
         std::make_unique<ParallelBZ2Reader>( std::make_unique<StandardFileReader>( encodedTestFilePath ) );
 
@@ -63,78 +80,59 @@ testDecodingBz2ForFirstTime( const std::string& decodedTestFilePath,
         {
             std::cerr << "Seek to " << offset << "\n";
 
-            /**
-             * Clear fail bit in order to seek back.
-             * When using read to read the number of bytes the file has, then no eof bit is set.
-             * As soon as you request one more byte than the file contains, both, the failbit and eofbit are set
-             * but only the eofbit will be cleared by seekg since C++11.
-             * @see https://en.cppreference.com/w/cpp/io/basic_istream/seekg
-             * > Before doing anything else, seekg clears eofbit. (since C++11)
-             */
-            if ( decodedFile.fail() ) {
-                decodedFile.clear();
-            }
-            decodedFile.seekg( offset, toSeekdir( origin ) );
-            const auto newSeekPosDecoded = static_cast<long long int>( decodedFile.tellg() );
-            const auto newSeekPosEncoded = static_cast<long long int>( encodedFile->seek( offset, origin ) );
-
-            /* Wanted differing behavior between std::ifstream and BZ2Reader. */
-            REQUIRE_EQUAL( std::min<long long int>( newSeekPosDecoded, decodedFileSize ), newSeekPosEncoded );
-            REQUIRE_EQUAL( std::min<long long int>( decodedFile.tellg(), decodedFileSize ),
-                           static_cast<long long int>( encodedFile->tell() ) );
-
-            /* Beware! eof behavior is different. std:ifstream requires to read more than the file contents
-             * for EOF to be reached while BZ2Reader only required to read more than >or equal< the file
-             * size of bytes. Furthermore, seeking beyond the file does not set EOF in std::ifstream but does
-             * set EOF in BZ2Reader! */
-            //REQUIRE_EQUAL( decodedFile.eof(), encodedFile->eof() );
+            const auto targetPosition =
+                origin == SEEK_SET
+                ? offset
+                : origin == SEEK_CUR
+                  ? static_cast<long long int>( decodedPosition ) + offset
+                  : static_cast<long long int>( decodedFileSize ) + offset;
+            decodedPosition = static_cast<size_t>(
+                std::clamp( targetPosition, 0LL, static_cast<long long int>( decodedFileSize ) ) );
+            decodedEof = decodedPosition >= decodedFileSize;
+
+            const auto newSeekPosEncoded = encodedFile->seek( offset, origin );
+
+            REQUIRE_EQUAL( decodedPosition, newSeekPosEncoded );
+            REQUIRE_EQUAL( decodedPosition, encodedFile->tell() );
+            REQUIRE_EQUAL( decodedEof, encodedFile->eof() );
         };
 
+    /* Reused across all read calls. One of them requests 1 GiB, so reallocating and filling
+     * a fresh buffer per call would touch gigabytes of memory for sentinel values alone. */
+    std::vector<char> encodedBuffer;
+
     const auto read =
         [&] ( size_t nBytesToRead )
         {
             std::cerr << "Read " << nBytesToRead << "B\n";
 
-            std::vector<char> decodedBuffer( nBytesToRead, 11 );
-            std::vector<char> encodedBuffer( nBytesToRead, 22 );
+            encodedBuffer.resize( nBytesToRead );
 
-            if ( !encodedFile->eof() ) {
-                REQUIRE_EQUAL( static_cast<size_t>( decodedFile.tellg() ), encodedFile->tell() );
-            }
-
-            /* Why doesn't the ifstream has a similar return specifying the number of read bytes?! */
-            decodedFile.read( decodedBuffer.data(), static_cast<std::streamsize>( nBytesToRead ) );
-            const auto nBytesReadDecoded = decodedFile.gcount();
+            REQUIRE_EQUAL( decodedPosition, encodedFile->tell() );
 
+            const auto nBytesReadDecoded = std::min( nBytesToRead, decodedFileSize - decodedPosition );
             const auto nBytesReadEncoded = encodedFile->read( -1, encodedBuffer.data(), nBytesToRead );
 
-            REQUIRE_EQUAL( static_cast<size_t>( nBytesReadDecoded ), nBytesReadEncoded );
+            REQUIRE_EQUAL( nBytesReadDecoded, nBytesReadEncoded );
 
-            decodedBuffer.resize( nBytesReadDecoded );
-            encodedBuffer.resize( nBytesReadEncoded );
+            /* Avoid REQUIRE_EQUAL on the buffers in order to avoid printing huge binary buffers out. */
+            const auto sizeToCompare = std::min( nBytesReadDecoded, nBytesReadEncoded );
+            const auto firstInequal = firstMismatch( groundTruth + decodedPosition, encodedBuffer.data(),
+                                                     sizeToCompare );
+            REQUIRE_EQUAL( firstInequal, sizeToCompare );
 
-            /* Encountering eof during read also sets fail bit meaning tellg will return -1! */
-            if ( !decodedFile.eof() ) {
-                REQUIRE_EQUAL( static_cast<long long int>( decodedFile.tellg() ),
-                               static_cast<long long int>( encodedFile->tell() ) );
-            }
-            REQUIRE_EQUAL( decodedFile.eof(), encodedFile->eof() );
-
-            /* Avoid REQUIRE_EQUAL in order to avoid printing huge binary buffers out. */
-            size_t equalElements = 0;
-            size_t firstInequal = std::numeric_limits<long int>::max();
-            for ( size_t i = 0; i < std::min( decodedBuffer.size(), encodedBuffer.size() ); ++i ) {
-                if ( decodedBuffer[i] == encodedBuffer[i] ) {
-                    ++equalElements;
-                } else {
-                    firstInequal = std::min( firstInequal, i );
-                }
+            if ( firstInequal != sizeToCompare ) {
+                std::cerr << "First inequal element at " << firstInequal << "\n";
             }
-            REQUIRE_EQUAL( equalElements, std::min( decodedBuffer.size(), encodedBuffer.size() ) );
 
-            if ( equalElements != std::min( decodedBuffer.size(), encodedBuffer.size() ) ) {
-                std::cerr << "First inequal element at " << firstInequal << "\n";
+            decodedPosition += nBytesReadDecoded;
+            /* Reading exactly up to the last byte does not set eof, only requesting more does. */
+            if ( nBytesReadDecoded < nBytesToRead ) {
+                decodedEof = true;
             }
+
+            REQUIRE_EQUAL( decodedPosition, encodedFile->tell() );
+            REQUIRE_EQUAL( decodedEof, encodedFile->eof() );
         };
 
     /* Try some subsequent small reads. */
@@ -224,8 +222,8 @@ testDecodingBz2ForFirstTime( const std::string& decodedTestFilePath,
     read( decodedFileSize + 1000 );
 
     std::cerr << "Test block offset loading\n";
-    decodedFile.clear();
-    decodedFile.seekg( 0 );
+    decodedPosition = 0;
+    decodedEof = false;
     encodedFile = std::make_unique<ParallelBZ2Reader>( std::make_unique<StandardFileReader>( encodedTestFilePath ) );
     encodedFile->setBlockOffsets( blockOffsets );
 
@@ -236,8 +234,8 @@ testDecodingBz2ForFirstTime( const std::string& decodedTestFilePath,
     }
 
     std::cerr << "Test block offset loading\n";
-    decodedFile.clear();
-    decodedFile.seekg( 0 );
+    decodedPosition = 0;
+    decodedEof = false;
     encodedFile = std::make_unique<ParallelBZ2Reader>( std::make_unique<StandardFileReader>( encodedTestFilePath ) );
     encodedFile->setBlockOffsets( blockOffsets );
 
@@ -246,8 +244,8 @@ testDecodingBz2ForFirstTime( const std::string& decodedTestFilePath,
     read( decodedFileSize + 1000 );
 
     std::cerr << "Test block offset loading after partial reading\n";
-    decodedFile.clear();
-    decodedFile.seekg( 0 );
+    decodedPosition = 0;
+    decodedEof = false;
     encodedFile = std::make_unique<ParallelBZ2Reader>( std::make_unique<StandardFileReader>( encodedTestFilePath ) );
     read( 4 );
     encodedFile->setBlockOffsets( blockOffsets );
@@ -3,22 +3,25 @@
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <common.hpp>
 #include <filereader/Buffered.hpp>
+#include <filereader/BufferView.hpp>
+#include <filereader/MemoryMap.hpp>
 #include <filereader/Standard.hpp>
 #include <GzipReader.hpp>
 #include <rapidgzip.hpp>
 #include <TestHelpers.hpp>
+#include <ThreadPool.hpp>
 
 
 using namespace rapidgzip;
@@ -47,22 +50,33 @@ const std::string_view NANO_SAMPLE_DECODED{
 };
 
 
-[[nodiscard]] std::pair<std::vector<char>, std::vector<char> >
-duplicateNanoStream( size_t multiples )
+/**
+ * Fills the result with @p multiples concatenated copies of @p pattern. Instead of appending one copy
+ * per iteration, the already filled prefix is doubled so that only O(log(multiples)) memcpy calls remain.
+ */
+template<typename Container>
+[[nodiscard]] std::vector<char>
+concatenatedCopies( const Container& pattern,
+                    size_t           multiples )
 {
-    std::vector<char> encoded( NANO_SAMPLE_GZIP.size() * multiples );
-    for ( size_t i = 0; i < multiples; ++i ) {
-        std::copy( NANO_SAMPLE_GZIP.begin(), NANO_SAMPLE_GZIP.end(),
-                   encoded.begin() + static_cast<std::ptrdiff_t>( i * NANO_SAMPLE_GZIP.size() ) );
+    std::vector<char> result( pattern.size() * multiples );
+    if ( result.empty() ) {
+        return result;
     }
 
-    std::vector<char> decoded( NANO_SAMPLE_DECODED.size() * multiples );
-    for ( size_t i = 0; i < multiples; ++i ) {
-        std::copy( NANO_SAMPLE_DECODED.begin(), NANO_SAMPLE_DECODED.end(),
-                   decoded.begin() + static_cast<std::ptrdiff_t>( i * NANO_SAMPLE_DECODED.size() ) );
+    std::memcpy( result.data(), pattern.data(), pattern.size() );
+    for ( size_t filled = pattern.size(); filled < result.size(); filled *= 2 ) {
+        std::memcpy( result.data() + filled, result.data(), std::min( filled, result.size() - filled ) );
     }
+    return result;
+}
+
 
-    return { encoded, decoded };
+[[nodiscard]] std::pair<std::vector<char>, std::vector<char> >
+duplicateNanoStream( size_t multiples )
+{
+    return { concatenatedCopies( NANO_SAMPLE_GZIP, multiples ),
+             concatenatedCopies( NANO_SAMPLE_DECODED, multiples ) };
 }
 
 
@@ -70,7 +84,7 @@ void
 testSerialDecoderNanoSample()
 {
     const std::vector<char> signedData( NANO_SAMPLE_GZIP.begin(), NANO_SAMPLE_GZIP.end() );
-    GzipReader gzipReader( std::make_unique<BufferedFileReader>( signedData ) );
+    GzipReader gzipReader( std::make_unique<BufferViewFileReader>( signedData ) );
     gzipReader.setCRC32Enabled( true );
 
     std::vector<char> result( NANO_SAMPLE_DECODED.size() + 10, 0 );
@@ -81,12 +95,13 @@ testSerialDecoderNanoSample()
 
 
 void
-testSerialDecoderNanoSample( size_t multiples,
-                             size_t bufferSize )
+testSerialDecoderNanoSample( GzipReader&              gzipReader,
+                             const std::vector<char>& encoded,
+                             const std::vector<char>& decoded,
+                             size_t                   bufferSize )
 {
-    const auto [encoded, decoded] = duplicateNanoStream( multiples );
-
-    GzipReader gzipReader( std::make_unique<BufferedFileReader>( encoded ) );
+    /* The encoded buffer outlives the reader, so a non-owning view avoids copying it again. */
+    gzipReader.reset( std::make_unique<BufferViewFileReader>( encoded ) );
     gzipReader.setCRC32Enabled( true );
 
     std::vector<char> result( bufferSize, 0 );
@@ -96,7 +111,8 @@ testSerialDecoderNanoSample( size_t multiples,
         if ( nBytesDecoded < result.size() ) {
             REQUIRE( nBytesDecoded == ( decoded.size() % bufferSize ) );
         }
-        REQUIRE( std::equal( result.begin(), result.begin() + nBytesDecoded, decoded.begin() + totalBytesDecoded ) );
+        REQUIRE( firstMismatch( result.data(), decoded.data() + totalBytesDecoded, nBytesDecoded )
+                 == nBytesDecoded );
         totalBytesDecoded += nBytesDecoded;
     }
 }
@@ -114,15 +130,15 @@ testSerialDecoderNanoSampleStoppingPoints()
             std::vector<size_t> offsets;
             std::vector<size_t> compressedOffsets;
 
-            GzipReader gzipReader( std::make_unique<BufferedFileReader>( encoded ) );
+            GzipReader gzipReader( std::make_unique<BufferViewFileReader>( encoded ) );
             gzipReader.setCRC32Enabled( true );
 
             std::vector<char> result( decoded.size(), 0 );
             size_t totalBytesDecoded = 0;
             while ( !gzipReader.eof() ) {
                 const auto nBytesDecoded = gzipReader.read( -1, result.data(), result.size(), stoppingPoint );
-                REQUIRE( std::equal( result.begin(), result.begin() + nBytesDecoded,
-                                     decoded.begin() + totalBytesDecoded ) );
+                REQUIRE( firstMismatch( result.data(), decoded.data() + totalBytesDecoded, nBytesDecoded )
+                         == nBytesDecoded );
                 totalBytesDecoded += nBytesDecoded;
 
                 offsets.emplace_back( gzipReader.tell() );
@@ -173,50 +189,69 @@ testSerialDecoderNanoSampleStoppingPoints()
 
 
 void
-testSerialDecoder( std::filesystem::path const& decodedFilePath,
-                   std::filesystem::path const& encodedFilePath,
-                   size_t                const  bufferSize )
+testSerialDecoder( const std::string& decodedFilePath,
+                   const std::string& encodedFilePath,
+                   size_t const       bufferSize )
 {
-    std::vector<char> decodedBuffer( bufferSize );
     std::vector<char> buffer( bufferSize );
 
+    /* Map the ground truth once so that each chunk can be compared against a direct view into the
+     * page cache instead of streaming it through a filebuf copy per comparison. */
+#ifdef HAVE_MMAP_FILE_READER
+    const MMapFileReader decodedFile( decodedFilePath );
+    const auto* const groundTruth = reinterpret_cast<const char*>( decodedFile.data() );
+    const auto groundTruthSize = decodedFile.size().value();
+#else
+    std::vector<char> groundTruthBuffer( fileSize( decodedFilePath ) );
     std::ifstream decodedFile( decodedFilePath );
+    decodedFile.read( groundTruthBuffer.data(), static_cast<std::ptrdiff_t>( groundTruthBuffer.size() ) );
+    REQUIRE( static_cast<size_t>( decodedFile.gcount() ) == groundTruthBuffer.size() );
+    const auto* const groundTruth = groundTruthBuffer.data();
+    const auto groundTruthSize = groundTruthBuffer.size();
+#endif
+
+#ifdef WITH_ISAL
+    /* Exercise the ISA-L backend for bulk reads. Small buffer sizes stay on the native decoder,
+     * whose per-call state resumption they are meant to test in the first place. */
+    const auto backend = bufferSize >= 128_Ki ? GzipReader::Backend::ISAL : GzipReader::Backend::NATIVE;
+    GzipReader gzipReader( std::make_unique<StandardFileReader>( encodedFilePath ), backend );
+#else
     GzipReader gzipReader( std::make_unique<StandardFileReader>( encodedFilePath ) );
+#endif
     gzipReader.setCRC32Enabled( true );
 
     size_t totalBytesDecoded{ 0 };
     while ( !gzipReader.eof() ) {
+        /* Do not shrink the buffer to the read count. Doing so capped all subsequent reads to the
+         * size of the first short read instead of the requested buffer size. */
         const auto nBytesRead = gzipReader.read( -1, buffer.data(), buffer.size() );
-        buffer.resize( nBytesRead );
         if ( nBytesRead == 0 ) {
             REQUIRE( gzipReader.eof() );
             break;
         }
 
         /* Compare with ground truth. */
-        decodedBuffer.resize( buffer.size() );
-        decodedFile.read( decodedBuffer.data(), static_cast<std::ptrdiff_t>( decodedBuffer.size() ) );
-        REQUIRE( !decodedFile.fail() );
-        REQUIRE( static_cast<size_t>( decodedFile.gcount() ) == buffer.size() );
-
-        REQUIRE( std::equal( buffer.begin(), buffer.end(), decodedBuffer.begin() ) );
-        if ( !std::equal( buffer.begin(), buffer.end(), decodedBuffer.begin() ) ) {
-            for ( size_t i = 0; i < buffer.size(); ++i ) {
-                if ( buffer[i] != decodedBuffer[i] ) {
-                    std::cerr << "Decoded contents differ at position " << i << " B: "
-                              << buffer[i] << " != " << decodedBuffer[i] << " ("
-                              << (int)buffer[i] << " != " << (int)decodedBuffer[i] << ") while decoding "
-                              << decodedFilePath << " with buffer size " << bufferSize << "\n";
-                    break;
-                }
-            }
+        REQUIRE( totalBytesDecoded + nBytesRead <= groundTruthSize );
+        if ( totalBytesDecoded + nBytesRead > groundTruthSize ) {
+            break;
         }
 
-        totalBytesDecoded += buffer.size();
+        const auto* const expected = groundTruth + totalBytesDecoded;
+        const auto mismatchPosition = firstMismatch( buffer.data(), expected, nBytesRead );
+        REQUIRE( mismatchPosition == nBytesRead );
+        if ( mismatchPosition < nBytesRead ) {
+            std::cerr << "Decoded contents differ at position " << mismatchPosition << " B: "
+                      << buffer[mismatchPosition] << " != " << expected[mismatchPosition] << " ("
+                      << (int)buffer[mismatchPosition] << " != " << (int)expected[mismatchPosition]
+                      << ") while decoding " << decodedFilePath << " with buffer size " << bufferSize << "\n";
+        }
+
+        totalBytesDecoded += nBytesRead;
     }
 
-    REQUIRE( totalBytesDecoded == fileSize( decodedFilePath ) );
-    std::cerr << "Decoded " << decodedFilePath.filename() << " with buffer size " << bufferSize << "\n";
+    REQUIRE( totalBytesDecoded == groundTruthSize );
+    std::cerr << "Decoded " << std::filesystem::path( decodedFilePath ).filename()
+              << " with buffer size " << bufferSize << "\n";
 }
 
 
@@ -249,22 +284,34 @@ testTwoStagedDecoding( const std::string& encodedFilePath,
 
     std::cout << "Test two-staged decoding for " << encodedFilePath << "\n";
 
-    /* Check that decompressed data and the last window match the ground truth. */
+    /* Check that decompressed data and the last window match the ground truth.
+     * The mapped view avoids streaming the ground truth through a filebuf copy per check. */
+#ifdef HAVE_MMAP_FILE_READER
+    const MMapFileReader decodedFile( decodedFilePath );
+    const auto* const groundTruth = reinterpret_cast<const char*>( decodedFile.data() );
+    const auto groundTruthSize = decodedFile.size().value();
+#else
+    std::vector<char> groundTruthBuffer( fileSize( decodedFilePath ) );
     std::ifstream decodedFile( decodedFilePath );
-    std::vector<char> uncompressed( decompressed.size() );
-    decodedFile.read( uncompressed.data(), static_cast<std::ptrdiff_t>( uncompressed.size() ) );
-    REQUIRE( std::equal( decompressed.begin(), decompressed.end(), uncompressed.begin() ) );
+    decodedFile.read( groundTruthBuffer.data(), static_cast<std::ptrdiff_t>( groundTruthBuffer.size() ) );
+    REQUIRE( static_cast<size_t>( decodedFile.gcount() ) == groundTruthBuffer.size() );
+    const auto* const groundTruth = groundTruthBuffer.data();
+    const auto groundTruthSize = groundTruthBuffer.size();
+#endif
+
+    REQUIRE( groundTruthSize >= firstBlockSize );
+    REQUIRE( firstMismatch( decompressed.data(), groundTruth, decompressed.size() ) == decompressed.size() );
 
     const auto validWindowSize = std::min( lastWindow.size(), firstBlockSize );
+    const auto* const windowGroundTruth = groundTruth + firstBlockSize - validWindowSize;
     const auto validWindowMatches = std::equal(
-        lastWindow.end() - validWindowSize, lastWindow.end(),
-        uncompressed.end() - static_cast<std::ptrdiff_t>( validWindowSize ),
+        lastWindow.end() - validWindowSize, lastWindow.end(), windowGroundTruth,
         [] ( auto a, auto b ) { return a == static_cast<decltype( a )>( b ); } );
     REQUIRE( validWindowMatches );
     if ( !validWindowMatches ) {
-        for ( size_t i = lastWindow.size() - validWindowSize; i < lastWindow.size(); ++i ) {
-            const auto correct = uncompressed[uncompressed.size() - validWindowSize + i];
-            const auto decoded = lastWindow.at( i );
+        for ( size_t i = 0; i < validWindowSize; ++i ) {
+            const auto correct = windowGroundTruth[i];
+            const auto decoded = lastWindow.at( lastWindow.size() - validWindowSize + i );
             if ( static_cast<char>( decoded ) != correct ) {
                 std::cerr << "Decoded contents differ at position " << i << " B: "
                           << decoded << " != " << correct << " ("
@@ -302,22 +349,16 @@ testTwoStagedDecoding( const std::string& encodedFilePath,
     }
 
     /* Compare concatenated result. */
-    std::vector<uint8_t> decodedBuffer( 1_Mi );
-    REQUIRE( decodedBuffer.size() >= concatenated.size() );
-    decodedFile.seekg( static_cast<long long int>( firstBlockSize ) );
-    decodedFile.read( reinterpret_cast<char*>( decodedBuffer.data() ),
-                      static_cast<long long int>( concatenated.size() ) );
-
-    REQUIRE( std::equal( concatenated.begin(), concatenated.end(), decodedBuffer.begin() ) );
-    if ( !std::equal( concatenated.begin(), concatenated.end(), decodedBuffer.begin() ) ) {
-        for ( size_t i = 0; i < concatenated.size(); ++i ) {
-            if ( concatenated[i] != decodedBuffer[i] ) {
-                std::cerr << "Decoded contents differ at position " << i << " B: "
-                          << concatenated[i] << " != " << decodedBuffer[i] << " ("
-                          << (int)concatenated[i] << " != " << (int)decodedBuffer[i] << ") (concatenated != file)\n";
-                break;
-            }
-        }
+    REQUIRE( groundTruthSize >= firstBlockSize + concatenated.size() );
+    const auto* const secondBlockGroundTruth = groundTruth + firstBlockSize;
+
+    const auto mismatchPosition = firstMismatch( concatenated.data(), secondBlockGroundTruth, concatenated.size() );
+    REQUIRE( mismatchPosition == concatenated.size() );
+    if ( mismatchPosition < concatenated.size() ) {
+        std::cerr << "Decoded contents differ at position " << mismatchPosition << " B: "
+                  << concatenated[mismatchPosition] << " != " << secondBlockGroundTruth[mismatchPosition] << " ("
+                  << (int)concatenated[mismatchPosition] << " != " << (int)secondBlockGroundTruth[mismatchPosition]
+                  << ") (concatenated != file)\n";
     }
 
     /* Replace marker bytes inside the block itself. */
@@ -336,10 +377,14 @@ main( int    argc,
 
     testSerialDecoderNanoSampleStoppingPoints();
     testSerialDecoderNanoSample();
+    /* One reader is reset and reused across the whole grid to avoid reconstructing it 36 times. */
+    GzipReader nanoSampleReader( std::make_unique<BufferViewFileReader>( nullptr, 0 ) );
     for ( const auto multiples : { 1, 2, 3, 10 } ) {
+        /* Build the duplicated sample once per multiple instead of once per buffer size. */
+        const auto [encoded, decoded] = duplicateNanoStream( multiples );
         for ( const auto bufferSize : std::vector<size_t>{ 1, 2, 3, 4, 12, 32, 300, 1_Ki, 1_Mi } ) {
             std::cerr << "Try to decode " << multiples << " nano samples with buffer size: " << bufferSize << "\n";
-            testSerialDecoderNanoSample( multiples, bufferSize );
+            testSerialDecoderNanoSample( nanoSampleReader, encoded, decoded, bufferSize );
         }
     }
 
@@ -354,34 +399,71 @@ main( int    argc,
             findParentFolderContaining( binaryFolder, "src/tests/data/base64-256KiB.bgz" )
         ) / "src" / "tests" / "data";
 
+    std::vector<std::filesystem::path> encodedTestFilePaths;
     for ( auto const& entry : std::filesystem::directory_iterator( testsFolder ) ) {
-        if ( !entry.is_regular_file() || !entry.path().has_extension() ) {
+        /* entry.path() returns a reference, but bind it once instead of recomputing member calls
+         * on a fresh expression for each of the four uses below. */
+        const auto& encodedFilePath = entry.path();
+        if ( !entry.is_regular_file() || !encodedFilePath.has_extension() ) {
             continue;
         }
 
-        const auto extension = entry.path().extension().string();
-        const std::unordered_set<std::string> validExtensions = { ".gz", ".bgz", ".igz", ".pigz" };
-        if ( validExtensions.find( extension ) == validExtensions.end() ) {
+        /* A handful of fixed extensions compares cheaper than rebuilding a hash set per entry.
+         * path::native avoids the extra string copy that path::string would make per entry. */
+        constexpr std::array<std::string_view, 4> validExtensions = { ".gz", ".bgz", ".igz", ".pigz" };
+        const auto extension = encodedFilePath.extension();
+    #ifdef _WIN32
+        const auto extensionString = extension.string();  /* native() would return std::wstring. */
+    #else
+        const std::string& extensionString = extension.native();
+    #endif
+        if ( std::find( validExtensions.begin(), validExtensions.end(), extensionString )
+             == validExtensions.end() ) {
             continue;
         }
 
-        const auto& encodedFilePath = entry.path();
-        auto decodedFilePath = entry.path();
+        auto decodedFilePath = encodedFilePath;
         decodedFilePath.replace_extension( "" );
-        if ( !std::filesystem::exists( decodedFilePath ) ) {
-            continue;
+        if ( std::filesystem::exists( decodedFilePath ) ) {
+            encodedTestFilePaths.emplace_back( encodedFilePath );
         }
+    }
 
-        for ( const auto bufferSize : std::vector<size_t>{ 1, 2, 12, 32, 1000, 1_Ki, 128_Ki, 1_Mi, 64_Mi } ) {
-            try {
-                testSerialDecoder( decodedFilePath.string(), encodedFilePath.string(), bufferSize );
-            } catch ( const std::exception& e ) {
-                std::cerr << "Exception was thrown: " << e.what() << "\n";
-                REQUIRE( false );
-            }
-        }
+    /* Each test file decodes independently, so spread the files over all cores. */
+    {
+        ThreadPool threadPool;
+        std::vector<std::future<void> > doneTestFiles;
+        doneTestFiles.reserve( encodedTestFilePaths.size() );
+        for ( const auto& encodedFilePath : encodedTestFilePaths ) {
+            doneTestFiles.emplace_back( threadPool.submit( [encodedFilePath] () {
+                auto decodedFilePath = encodedFilePath;
+                decodedFilePath.replace_extension( "" );
+
+                /* Convert both paths to strings once instead of allocating a fresh copy with
+                 * path::string for each of the per-buffer-size test calls. */
+            #ifdef _WIN32
+                const auto encodedFileName = encodedFilePath.string();
+                const auto decodedFileName = decodedFilePath.string();
+            #else
+                const std::string& encodedFileName = encodedFilePath.native();
+                const std::string& decodedFileName = decodedFilePath.native();
+            #endif
+
+                for ( const auto bufferSize : std::vector<size_t>{ 1, 2, 12, 32, 1000, 1_Ki, 128_Ki, 1_Mi, 64_Mi } ) {
+                    try {
+                        testSerialDecoder( decodedFileName, encodedFileName, bufferSize );
+                    } catch ( const std::exception& e ) {
+                        std::cerr << "Exception was thrown: " << e.what() << "\n";
+                        REQUIRE( false );
+                    }
+                }
 
-        testTwoStagedDecoding( encodedFilePath.string(), decodedFilePath.string() );
+                testTwoStagedDecoding( encodedFileName, decodedFileName );
+            } ) );
+        }
+        for ( auto& doneTestFile : doneTestFiles ) {
+            doneTestFile.get();
+        }
     }
 
     std::cout << "Tests successful: " << ( gnTests - gnTestErrors ) << " / " << gnTests << "\n";
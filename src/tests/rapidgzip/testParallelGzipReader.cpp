@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -57,22 +59,33 @@ const auto DNA_SYMBOLS =
     }();
 
 
-[[nodiscard]] std::pair<std::vector<char>, std::vector<char> >
-duplicateNanoStream( size_t multiples )
+/**
+ * Fills the result with @p multiples concatenated copies of @p pattern. Instead of appending one copy
+ * per iteration, the already filled prefix is doubled so that only O(log(multiples)) memcpy calls remain.
+ */
+template<typename Container>
+[[nodiscard]] std::vector<char>
+concatenatedCopies( const Container& pattern,
+                    size_t           multiples )
 {
-    std::vector<char> encoded( NANO_SAMPLE_GZIP.size() * multiples );
-    for ( size_t i = 0; i < multiples; ++i ) {
-        std::copy( NANO_SAMPLE_GZIP.begin(), NANO_SAMPLE_GZIP.end(),
-                   encoded.begin() + static_cast<std::ptrdiff_t>( i * NANO_SAMPLE_GZIP.size() ) );
+    std::vector<char> result( pattern.size() * multiples );
+    if ( result.empty() ) {
+        return result;
     }
 
-    std::vector<char> decoded( NANO_SAMPLE_DECODED.size() * multiples );
-    for ( size_t i = 0; i < multiples; ++i ) {
-        std::copy( NANO_SAMPLE_DECODED.begin(), NANO_SAMPLE_DECODED.end(),
-                   decoded.begin() + static_cast<std::ptrdiff_t>( i * NANO_SAMPLE_DECODED.size() ) );
+    std::memcpy( result.data(), pattern.data(), pattern.size() );
+    for ( size_t filled = pattern.size(); filled < result.size(); filled *= 2 ) {
+        std::memcpy( result.data() + filled, result.data(), std::min( filled, result.size() - filled ) );
     }
+    return result;
+}
+
 
-    return { encoded, decoded };
+[[nodiscard]] std::pair<std::vector<char>, std::vector<char> >
+duplicateNanoStream( size_t multiples )
+{
+    return { concatenatedCopies( NANO_SAMPLE_GZIP, multiples ),
+             concatenatedCopies( NANO_SAMPLE_DECODED, multiples ) };
 }
 
 
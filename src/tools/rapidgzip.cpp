@@ -1,9 +1,12 @@
+#include <array>
+#include <cassert>
 #include <cstdio>
 #include <iostream>
 #include <functional>
 #include <iterator>
 #include <map>
 #include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -73,24 +76,61 @@ template<typename Reader>
 void
 printIndexAnalytics( const Reader& reader )
 {
-    const auto offsets = reader->blockOffsets();
+    const auto offsets = reader->blockOffsetsVector();
     if ( offsets.size() <= 1 ) {
         return;
     }
 
     /* Analyze the offsets. */
 
-    Statistics<double> encodedOffsetSpacings;
-    Statistics<double> decodedOffsetSpacings;
+    /* Accumulate the spacings as plain integers so that the possibly hundreds of thousands of seek points
+     * do not each pay for a floating-point dependency chain; the conversion to MB happens only once at
+     * print time. The squared sum needs 128 bits because squared multi-MiB spacings overflow 64 bits. */
+    struct OffsetSpacings
+    {
+        void
+        merge( const uint64_t value ) noexcept
+        {
+            min = std::min( min, value );
+            max = std::max( max, value );
+            sum += value;
+            sum2 += static_cast<unsigned __int128>( value ) * value;
+            ++count;
+        }
+
+        [[nodiscard]] Statistics<double>
+        toStatistics( const double scale ) const
+        {
+            Statistics<double> result;
+            result.min = static_cast<double>( min ) * scale;
+            result.max = static_cast<double>( max ) * scale;
+            result.sum = static_cast<double>( sum ) * scale;
+            result.sum2 = static_cast<double>( sum2 ) * scale * scale;
+            result.count = count;
+            return result;
+        }
+
+        uint64_t min{ std::numeric_limits<uint64_t>::max() };
+        uint64_t max{ 0 };
+        uint64_t sum{ 0 };
+        unsigned __int128 sum2{ 0 };
+        uint64_t count{ 0 };
+    };
+
+    OffsetSpacings encodedSpacings;
+    OffsetSpacings decodedSpacings;
     for ( auto it = offsets.begin(), nit = std::next( offsets.begin() ); nit != offsets.end(); ++it, ++nit ) {
         const auto& [encodedOffset, decodedOffset] = *it;
         const auto& [nextEncodedOffset, nextDecodedOffset] = *nit;
         if ( nextEncodedOffset - encodedOffset > 0 ) {
-            encodedOffsetSpacings.merge( static_cast<double>( nextEncodedOffset - encodedOffset ) / CHAR_BIT / 1e6 );
-            decodedOffsetSpacings.merge( static_cast<double>( nextDecodedOffset - decodedOffset ) / 1e6 );
+            encodedSpacings.merge( nextEncodedOffset - encodedOffset );
+            decodedSpacings.merge( nextDecodedOffset - decodedOffset );
         }
     }
 
+    const auto encodedOffsetSpacings = encodedSpacings.toStatistics( 1.0 / CHAR_BIT / 1e6 );
+    const auto decodedOffsetSpacings = decodedSpacings.toStatistics( 1.0 / 1e6 );
+
     std::cerr
         << "[Seekpoints Index]\n"
         << "    Encoded offset spacings: ( min: " << encodedOffsetSpacings.min << ", "
@@ -104,14 +144,15 @@ printIndexAnalytics( const Reader& reader )
     const auto gzipIndex = reader->gzipIndex();
     if ( gzipIndex.windows ) {
         const auto [lock, windows] = gzipIndex.windows->data();
-        const auto compressedWindowSize =
-            std::accumulate( windows->begin(), windows->end(), size_t( 0 ), [] ( size_t sum, const auto& kv ) {
-                return sum + ( kv.second ? kv.second->compressedSize() : 0 );
-            } );
-        const auto decompressedWindowSize =
-            std::accumulate( windows->begin(), windows->end(), size_t( 0 ), [] ( size_t sum, const auto& kv ) {
-                return sum + ( kv.second ? kv.second->decompressedSize() : 0 );
-            } );
+        /* WindowMap::emplaceShared never inserts null windows, so both sizes can be gathered in a single pass
+         * without rechecking the shared_ptr for each of the possibly hundreds of thousands of entries. */
+        size_t compressedWindowSize{ 0 };
+        size_t decompressedWindowSize{ 0 };
+        for ( const auto& [offset, window] : *windows ) {
+            assert( window );
+            compressedWindowSize += window->compressedSize();
+            decompressedWindowSize += window->decompressedSize();
+        }
         std::cerr << "    Windows Count: " << windows->size() << "\n"
                   << "    Total Compressed Window Size: " << formatBytes( compressedWindowSize ) << "\n"
                   << "    Total Decompressed Window Size: " << formatBytes( decompressedWindowSize ) << "\n";
@@ -167,16 +208,36 @@ decompressParallel( const Arguments&   args,
     }
 
     if ( !args.indexSavePath.empty() ) {
-        const auto file = throwingOpen( args.indexSavePath, "wb" );
-        const auto checkedWrite =
-            [&file] ( const void* buffer, size_t size )
-            {
-                if ( std::fwrite( buffer, 1, size, file.get() ) != size ) {
-                    throw std::runtime_error( "Failed to write data to index!" );
-                }
-            };
+    #ifdef HAVE_O_DIRECT
+        /* Indexes with windows can grow to GiBs. Writing them with O_DIRECT avoids polluting the page cache
+         * with data we will not read back, which would evict the input file pages still used for decoding.
+         * Not all file systems support O_DIRECT, e.g., tmpfs does not, so fall back to buffered writes. */
+        std::optional<DirectWriteFileBuffer> directFile;
+        try {
+            directFile.emplace( args.indexSavePath );
+        } catch ( const std::exception& ) {
+            directFile.reset();
+        }
+
+        if ( directFile ) {
+            reader->exportIndex( [&directFile] ( const void* buffer, size_t size )
+                                 { directFile->write( buffer, size ); },
+                                 args.indexFormat );
+            directFile->close();
+        } else
+    #endif
+        {
+            const auto file = throwingOpen( args.indexSavePath, "wb" );
+            const auto checkedWrite =
+                [&file] ( const void* buffer, size_t size )
+                {
+                    if ( std::fwrite( buffer, 1, size, file.get() ) != size ) {
+                        throw std::runtime_error( "Failed to write data to index!" );
+                    }
+                };
 
-        reader->exportIndex( checkedWrite, args.indexFormat );
+            reader->exportIndex( checkedWrite, args.indexFormat );
+        }
     }
 
     if ( args.verbose && args.indexLoadPath.empty() && !args.indexSavePath.empty() ) {
@@ -227,6 +288,15 @@ int
 rapidgzipCLI( int                  argc,
               char const * const * argv )
 {
+    /* All output to arbitrary file descriptors goes through write/fwrite, so the C++ streams do not need to
+     * stay in sync with stdio. Give std::cerr, which is unbuffered by default, a real buffer so that verbose
+     * runs with many small status lines, e.g., the index analytics, do not degrade into one write per "<<". */
+    std::ios::sync_with_stdio( false );
+    std::cin.tie( nullptr );
+    static std::array<char, 64_Ki> stderrBuffer;
+    std::cerr.rdbuf()->pubsetbuf( stderrBuffer.data(), stderrBuffer.size() );
+    std::cerr << std::nounitbuf;
+
     /* Cleaned, checked, and typed arguments. */
     Arguments args;
 
@@ -322,6 +392,18 @@ rapidgzipCLI( int                  argc,
     const auto getParallelism = [] ( const auto p ) { return p > 0 ? p : availableCores(); };
     args.decoderParallelism = getParallelism( parsedArgs["decoder-parallelism"].as<unsigned int>() );
 
+    /* Parse and validate the chunk size once, here, next to the other decoder configuration, so that every
+     * decompressParallel dispatch sees the requested value instead of the Arguments default. */
+    args.chunkSize = parsedArgs["chunk-size"].as<unsigned int>() * 1_Ki;
+    if ( args.chunkSize < 128_Ki ) {
+        if ( !quiet ) {
+            std::cerr << "[Warning] Chunk sizes below 128 KiB are rarely beneficial because each chunk "
+                      << "has to decode up to 32 KiB of discardable data to resolve its window. "
+                      << "Will use 128 KiB instead of the requested " << formatBytes( args.chunkSize ) << ".\n";
+        }
+        args.chunkSize = 128_Ki;
+    }
+
     if ( args.verbose ) {
         for ( auto const* const path : { "input", "output" } ) {
             std::string value = "<none>";
@@ -349,7 +431,10 @@ rapidgzipCLI( int                  argc,
     }
 
     if ( parsedArgs.count( "oss-attributions" ) > 0 ) {
-        std::cout
+        /* Assemble the whole attribution block first and emit it with a single write instead of dozens of
+         * small stream insertions, each with its own sentry and state checks. */
+        std::stringstream attributions;
+        attributions
             << "# " << thirdparty::cxxopts::name << "\n\n"
             << thirdparty::cxxopts::url << "\n\n"
             << thirdparty::cxxopts::license << "\n\n"
@@ -366,11 +451,14 @@ rapidgzipCLI( int                  argc,
             << "# " << thirdparty::zlib::name << "\n\n"
             << thirdparty::zlib::url << "\n\n"
             << thirdparty::zlib::license;
+        const auto body = std::move( attributions ).str();
+        std::fwrite( body.data(), 1, body.size(), stdout );
         return 0;
     }
 
     if ( parsedArgs.count( "oss-attributions-yaml" ) > 0 ) {
-        std::cout
+        std::stringstream attributions;
+        attributions
             << "root_name: rapidgzip\n"
             << "third_party_libraries:\n"
             << "  - package_name: " << thirdparty::cxxopts::name << "\n"
@@ -406,6 +494,8 @@ rapidgzipCLI( int                  argc,
             << "    licenses:\n"
             << "      - license: Zlib\n"
             << "        text: " << toYamlString( thirdparty::zlib::license ) << "\n";
+        const auto body = std::move( attributions ).str();
+        std::fwrite( body.data(), 1, body.size(), stdout );
         return 0;
     }
 
@@ -588,8 +678,6 @@ rapidgzipCLI( int                  argc,
             }
         };
 
-    args.chunkSize = parsedArgs["chunk-size"].as<unsigned int>() * 1_Ki;
-
     auto errorCode = DecompressErrorCode::SUCCESS;
     const auto hasOutputFiles = ( outputFileDescriptor != -1 ) || ( stdoutFileDescriptor != -1 );
     if ( args.indexSavePath.empty() && countBytes && !countLines && !decompress && !hasOutputFiles ) {